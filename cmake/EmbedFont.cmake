@@ -0,0 +1,28 @@
+
+# Function to embed a font into a target
+#
+#   openll_embed_font(<target> <font> <function>)
+#
+# Compiles the font description (.fnt) and its glyph atlas with openll-fontc
+# into a generated source file that is added to the target. The header
+# <function>.h declares std::unique_ptr<openll::FontFace> <function>(),
+# which loads the font face without file access or parsing.
+function(openll_embed_font target font function)
+    get_filename_component(font_path "${font}" ABSOLUTE)
+
+    set(output_path "${CMAKE_CURRENT_BINARY_DIR}/embedded-fonts")
+    set(output      "${output_path}/${function}.cpp")
+
+    file(MAKE_DIRECTORY "${output_path}")
+
+    add_custom_command(
+        OUTPUT  "${output}" "${output_path}/${function}.h"
+        COMMAND openll-fontc "${font_path}" "${output}" ${function}
+        DEPENDS openll-fontc "${font_path}"
+        COMMENT "Embedding font ${font}"
+        VERBATIM
+    )
+
+    set_property(TARGET ${target} APPEND PROPERTY SOURCES "${output}")
+    target_include_directories(${target} PRIVATE "${output_path}")
+endfunction()
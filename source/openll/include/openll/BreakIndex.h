@@ -0,0 +1,160 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+class FontFace;
+class LineBreakTable;
+
+
+/**
+*  @brief
+*    Line break opportunities and pen positions of a text for a font face
+*
+*    The break index stores the position of each glyph on a single,
+*    unwrapped line (including kerning) as well as the positions at
+*    which lines can be broken, i.e., behind line feeds and wherever the
+*    line break classes of adjacent characters allow for it (see
+*    LineBreakTable::isBreakOpportunity()).
+*    With it, the end of a wrapped line is found by binary searches
+*    instead of testing each glyph, so re-wrapping a text for another
+*    line width takes time proportional to the number of lines.
+*
+*    Break indices are immutable. They are built lazily and cached by
+*    Text (see Text::breakIndex()).
+*/
+class OPENLL_API BreakIndex
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] text
+    *    Text to index
+    *  @param[in] lineFeed
+    *    Character that marks the end of a line
+    *  @param[in] fontFace
+    *    Font face providing advances and kernings
+    *  @param[in] lineBreakTable
+    *    Line break classes of the characters
+    */
+    BreakIndex(const std::u32string & text, char32_t lineFeed, const FontFace & fontFace, const LineBreakTable & lineBreakTable);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~BreakIndex();
+
+    /**
+    *  @brief
+    *    Check if the index has been built for a font face and line break table in their current state
+    *
+    *  @param[in] fontFace
+    *    Font face to check
+    *  @param[in] lineBreakTable
+    *    Line break table to check
+    *
+    *  @return
+    *    'true' if the index is up to date for both, else 'false'
+    */
+    bool isValid(const FontFace & fontFace, const LineBreakTable & lineBreakTable) const;
+
+    /**
+    *  @brief
+    *    Check if the index has been built for a font face and line break table, regardless of their state
+    *
+    *  @param[in] fontFace
+    *    Font face to check
+    *  @param[in] lineBreakTable
+    *    Line break table to check
+    *
+    *  @return
+    *    'true' if the index has been built for both, else 'false'
+    */
+    bool isBuiltFor(const FontFace & fontFace, const LineBreakTable & lineBreakTable) const;
+
+    /**
+    *  @brief
+    *    Get number of indexed glyphs
+    *
+    *  @return
+    *    Number of glyphs (i.e., characters of the text)
+    */
+    std::size_t size() const;
+
+    /**
+    *  @brief
+    *    Get pen position of a glyph on the unwrapped line
+    *
+    *  @param[in] index
+    *    Index of the glyph
+    *
+    *  @return
+    *    Pen position of the glyph, including kerning to its predecessor
+    */
+    double pen(std::size_t index) const;
+
+    /**
+    *  @brief
+    *    Get width of a line
+    *
+    *  @param[in] begin
+    *    Index of the first glyph of the line
+    *  @param[in] end
+    *    Index behind the last glyph of the line
+    *
+    *  @return
+    *    Distance from the pen of the first glyph to the end of the
+    *    last depictable glyph, 0 if the line has no depictable glyph
+    */
+    double width(std::size_t begin, std::size_t end) const;
+
+    /**
+    *  @brief
+    *    Find the end of a line
+    *
+    *    The line ends at the next line feed (inclusive) or at the last
+    *    break opportunity before, at which the line fits into the line
+    *    width. If not even the first word fits, the word is broken behind
+    *    the last glyph that fits, keeping at least one depictable glyph on
+    *    the line. Trailing non-depictable glyphs (e.g., spaces) do not
+    *    count towards the width of a line.
+    *
+    *  @param[in] begin
+    *    Index of the first glyph of the line
+    *  @param[in] lineWidth
+    *    Maximum width of the line
+    *
+    *  @return
+    *    Index behind the last glyph of the line
+    */
+    std::size_t lineEnd(std::size_t begin, double lineWidth) const;
+
+
+protected:
+    const FontFace           * m_fontFace;                 ///< Font face the index was built for
+    std::uint64_t              m_fontFaceGeneration;       ///< Generation of the font face when the index was built
+    const LineBreakTable     * m_lineBreakTable;           ///< Line break table the index was built for
+    std::uint64_t              m_lineBreakTableGeneration; ///< Generation of the line break table when the index was built
+    std::vector<double>        m_pens;                     ///< Pen position of each glyph on the unwrapped line
+    std::vector<double>        m_ends;                     ///< Pen position behind each glyph on the unwrapped line
+    std::vector<std::uint32_t> m_lastDepictable;           ///< Index + 1 of the last depictable glyph up to each glyph (0 if none)
+    std::vector<std::uint32_t> m_breaks;                   ///< Indices behind glyphs that allow for a line break
+    std::vector<std::uint32_t> m_lineFeeds;                ///< Indices behind line feeds
+};
+
+
+} // namespace openll
@@ -2,16 +2,25 @@
 #pragma once
 
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
-#include <map>
-#include <unordered_map>
 
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 
-#include <globjects/Texture.h>
-
 #include <openll/Glyph.h>
+#include <openll/GlyphAtlas.h>
+#include <openll/GlyphMetricsTable.h>
+
+
+namespace globjects
+{
+    class Texture;
+}
 
 
 namespace openll
@@ -43,9 +52,22 @@ namespace openll
 *  @remarks
 *    This class does not provide dpi awareness. This has to be handled
 *    outside of this class, e.g., during layouting and rendering.
+*
+*  @remarks
+*    All const member functions are safe to be called concurrently, e.g.,
+*    when typesetting labels of the same font face on multiple threads.
+*    They do not modify the font face, except for updating the glyph
+*    metrics table after mutable glyph access, which is synchronized.
+*    The exceptions are glyphTexture() and uploadGlyphTexture(), which
+*    require the OpenGL context.
+*    Modifications (including access to a mutable glyph) must not happen
+*    concurrently with any other access.
 */
 class OPENLL_API FontFace
 {
+    friend class FontLoader;
+    friend class FontWriter;
+
 public:
     /**
     *  @brief
@@ -264,21 +286,69 @@ public:
     */
     void setGlyphTexturePadding(const glm::vec4 & padding);
 
+    /**
+    *  @brief
+    *    Get the font face's glyph texture atlas in main memory
+    *
+    *  @return
+    *    Glyph texture atlas (empty if none was loaded)
+    */
+    const GlyphAtlas & glyphAtlas() const;
+
+    /**
+    *  @brief
+    *    Set the font face's glyph texture atlas in main memory
+    *
+    *    A previously created glyph texture is released, so the
+    *    texture is recreated from the new atlas on next access.
+    *
+    *  @param[in] atlas
+    *    Glyph texture atlas
+    */
+    void setGlyphAtlas(GlyphAtlas && atlas);
+
     /**
     *  @brief
     *    Get the font face's associated glyph texture
     *
-    *    All glyph data is associated to this texture atlas.
+    *    All glyph data is associated to this texture atlas. If no texture
+    *    was set, it is created from the glyph atlas on first access. This
+    *    is the only operation of the font face that requires an OpenGL
+    *    context, so it has to be called on the context's thread.
     *
     *  @return
-    *    Texture containing the glyph texture atlas
+    *    Texture containing the glyph texture atlas, 'nullptr' if neither a texture nor an atlas is available
     */
     globjects::Texture * glyphTexture() const;
 
+    /**
+    *  @brief
+    *    Upload the next rows of the glyph atlas to the glyph texture
+    *
+    *    Spreads the upload of large atlases over several frames. The first
+    *    call allocates the texture, each call uploads a band of complete
+    *    rows that fits into the budget (at least one row). Rows that are
+    *    not yet uploaded when glyphTexture() is accessed are uploaded at
+    *    once. Like glyphTexture(), this requires the OpenGL context.
+    *
+    *    Typesetting does not access the glyph texture, vertex clouds
+    *    resolve it when rendered (see GlyphVertexCloud::texture()). Render
+    *    text of the font face once this returns 'true' to keep the budget.
+    *
+    *  @param[in] maxBytes
+    *    Maximum number of bytes to upload, to be shared by all font faces uploaded in one frame
+    *
+    *  @return
+    *    'true' if the glyph texture is complete, else 'false'
+    */
+    bool uploadGlyphTexture(std::size_t maxBytes) const;
+
     /**
     *  @brief
     *    Set the font face's associated glyph texture
     *
+    *    The texture takes precedence over the glyph atlas.
+    *
     *  @param[in] texture
     *    Texture containing the glyph texture atlas
     */
@@ -308,6 +378,10 @@ public:
     *
     *  @return
     *    Reference to the glyph with the matching index
+    *
+    *  @remarks
+    *    Glyphs are stored contiguously, so adding glyphs invalidates
+    *    references to glyphs returned earlier.
     */
     Glyph & glyph(size_t index);
 
@@ -322,7 +396,11 @@ public:
     *    Index of the glyph to access
     *
     *  @return
-    *    Reference to the glyph with the matching index, or a blank glyph if not found
+    *    Reference to the glyph with the matching index, or the font face's empty glyph if not found
+    *
+    *  @remarks
+    *    Look-up is constant time: a flat table for the basic multilingual
+    *    plane and a table of pages of 256 glyphs for higher code points.
     */
     const Glyph & glyph(size_t index) const;
 
@@ -331,7 +409,8 @@ public:
     *    Add a glyph to the font face
     *
     *    If the glyph already exists, the existing glyph remains
-    *    and an assertion is thrown.
+    *    and an assertion is thrown. The glyph's index has to be
+    *    a unicode code point (below 0x110000).
     *
     *  @param[in] glyph
     *    Glyph to add
@@ -388,22 +467,108 @@ public:
     */
     float kerning(size_t index, size_t subsequentIndex) const;
 
+    /**
+    *  @brief
+    *    Check if any kerning is available
+    *
+    *    Allows to skip kerning look-ups entirely for font faces without kerning pairs.
+    *
+    *  @return
+    *    'true' if at least one kerning pair was set, else 'false'
+    */
+    bool hasKerning() const;
+
     /**
     *  @brief
     *    Set the kerning for a glyph and a subsequent glyph (in pt)
     *
-    *    If the glyph is known to this font face, the values are
-    *    forwarded to the glyphs kerning setter (see Glyph for more information).
+    *    If either one of the glyphs is unknown to this font face, the
+    *    pair is dropped and an assertion is thrown.
     *
     *  @param[in] index
     *    The target glyph index
     *  @param[in] subsequentIndex
     *    The glyph index of the respective subsequent/next glyph
     *  @param[in] kerning
-    *    Kerning of the two glyphs (in pt)
+    *    Kerning of the two glyphs (in pt, stored with a precision of 1/64 pt)
+    *
+    *  @remarks
+    *    Kernings are stored in one sorted array, so adding a pair takes
+    *    time linear in the number of kerning pairs and glyphs. Use
+    *    setKernings() to set many pairs at once.
     */
     void setKerning(size_t index, size_t subsequentIndex, float kerning);
 
+    /**
+    *  @brief
+    *    Replace all kernings by a list of kerning pairs
+    *
+    *    Equivalent to calling setKerning() for each pair in order, but
+    *    linear in the number of pairs and glyphs.
+    *
+    *  @param[in] indices
+    *    Glyph indices of the pairs
+    *  @param[in] subsequentIndices
+    *    Subsequent glyph indices of the pairs
+    *  @param[in] kernings
+    *    Kerning amounts of the pairs (in pt)
+    */
+    void setKernings(const std::vector<std::uint32_t> & indices, const std::vector<std::uint32_t> & subsequentIndices, const std::vector<float> & kernings);
+
+    /**
+    *  @brief
+    *    Get generation of the font face
+    *
+    *    The generation is a globally unique number that changes whenever
+    *    glyphs or kernings are added or modified. Modifications through
+    *    mutable glyph references are detected on the next call, by
+    *    comparing the glyph metrics. It can be used to invalidate cached
+    *    glyph metrics and kernings.
+    *
+    *  @return
+    *    Generation of the font face
+    */
+    std::uint64_t generation() const;
+
+    /**
+    *  @brief
+    *    Get dense id of a glyph
+    *
+    *    Glyphs are numbered contiguously in order of addition. The id
+    *    indexes the glyph metrics table.
+    *
+    *  @param[in] index
+    *    Index of the glyph
+    *
+    *  @return
+    *    Id of the glyph, 0 (the empty glyph) if the glyph is missing
+    */
+    std::uint32_t glyphId(size_t index) const;
+
+    /**
+    *  @brief
+    *    Get packed metrics of all glyphs for typesetting
+    *
+    *    The table is updated when glyphs are added. Glyphs accessed
+    *    mutably are updated in the table on the next call.
+    *
+    *  @return
+    *    Glyph metrics by glyph id
+    */
+    const GlyphMetricsTable & glyphMetrics() const;
+
+    /**
+    *  @brief
+    *    Get approximate memory usage of the font face
+    *
+    *    Includes the glyph tables, kernings, and glyph atlas in main
+    *    memory, as well as the glyph texture if it has been created.
+    *
+    *  @return
+    *    Memory usage in bytes
+    */
+    std::size_t memoryUsage() const;
+
 
 protected:
     float      m_ascent;                    ///< Distance from the baseline to the tops of the tallest glyphs (ascenders) in pt
@@ -413,17 +578,92 @@ protected:
     glm::vec2  m_inverseGlyphTextureExtent; ///< The size of the glyph texture in px
     glm::vec4  m_glyphTexturePadding;       ///< The padding applied to every glyph in px
 
-    std::unique_ptr<globjects::Texture>      m_glyphTexture; ///< The font face's associated glyph texture
-    std::unordered_map<size_t, Glyph>        m_glyphs;       ///< Quick-access container for all added glyphs
-    std::unordered_map<std::uint64_t, float> m_kernings;     ///< Kerning Look-up-table; the key is the concatenation of the two glyph indices
+    GlyphAtlas                          m_glyphAtlas;     ///< The font face's glyph texture atlas in main memory
+    std::vector<Glyph>                  m_glyphs;         ///< All glyphs by dense id, the empty glyph for missing glyphs has id 0
+    std::vector<std::uint32_t>          m_glyphIds;       ///< Dense id by glyph index for the basic multilingual plane (0 if missing)
+    std::vector<std::uint32_t>          m_pageIds;        ///< Page number + 1 by block of 256 glyph indices above the basic multilingual plane (0 if none)
+    std::vector<std::uint32_t>          m_pages;          ///< Dense ids of the glyph indices of all pages (0 if missing)
+    std::vector<std::uint32_t>          m_kerningOffsets; ///< Begin of the kerning run by glyph id (one past the last glyph id marks the end)
+    std::vector<std::uint32_t>          m_kerningIndices; ///< Subsequent glyph indices of all kernings, sorted within each run (empty if stored externally)
+    std::vector<std::int16_t>           m_kerningAmounts; ///< Kerning amounts in 1/64 pt, parallel to m_kerningIndices (empty if stored externally)
+    std::vector<std::uint64_t>          m_kerningMasks;   ///< Bit mask of the subsequent glyph indices (modulo 64) in the kerning run by glyph id
+    const std::uint32_t               * m_kerningIndexData;  ///< Subsequent glyph indices of all kernings (m_kerningIndices or external storage)
+    const std::int16_t                * m_kerningAmountData; ///< Kerning amounts in 1/64 pt (m_kerningAmounts or external storage)
+    std::size_t                         m_kerningCount;      ///< Number of kernings
+
+    mutable std::uint64_t                       m_generation;            ///< Globally unique number that changes on modification of glyphs or kernings
+    mutable std::unique_ptr<globjects::Texture> m_glyphTexture;          ///< The font face's associated glyph texture (created lazily from the atlas)
+    mutable unsigned int                        m_glyphTextureRows;      ///< Number of glyph atlas rows uploaded to the glyph texture
+    mutable GlyphMetricsTable                   m_glyphMetrics;          ///< Packed metrics of all glyphs by glyph id
+    mutable std::vector<std::uint32_t>          m_modifiedGlyphIds;      ///< Ids of mutably accessed glyphs, to be updated in m_glyphMetrics
+    mutable std::atomic<bool>                   m_glyphMetricsModified;  ///< Are there glyphs to be updated in m_glyphMetrics?
+    mutable std::mutex                          m_glyphMetricsMutex;     ///< Synchronizes concurrent updates of m_glyphMetrics
 
 
 protected:
-    static std::uint64_t kerningIndex(char32_t firstIndex, char32_t secondIndex);
+    /**
+    *  @brief
+    *    Insert a glyph that is not yet mapped
+    *
+    *  @param[in] glyph
+    *    Glyph to insert (index has to be a unicode code point)
+    *
+    *  @return
+    *    Id of the inserted glyph, 0 if its index is out of range
+    */
+    std::uint32_t insertGlyph(Glyph && glyph);
 
+    /**
+    *  @brief
+    *    Replace all kernings
+    *
+    *  @param[in] offsets
+    *    Begin of the kerning run by glyph id, followed by the end of the last run (empty if there are no kernings)
+    *  @param[in] indices
+    *    Subsequent glyph indices of all kernings, sorted within each run
+    *  @param[in] amounts
+    *    Kerning amounts in 1/64 pt
+    */
+    void setKernings(std::vector<std::uint32_t> && offsets, std::vector<std::uint32_t> && indices, std::vector<std::int16_t> && amounts);
+
+    /**
+    *  @brief
+    *    Replace all kernings by kernings in external storage
+    *
+    *    The indices and amounts are referenced instead of copied, until
+    *    kernings are modified (e.g., for fonts embedded in the executable).
+    *
+    *  @param[in] offsets
+    *    Begin of the kerning run by glyph id, followed by the end of the last run (empty if there are no kernings)
+    *  @param[in] indices
+    *    Subsequent glyph indices of all kernings, sorted within each run (has to outlive the font face)
+    *  @param[in] amounts
+    *    Kerning amounts in 1/64 pt (has to outlive the font face)
+    *  @param[in] count
+    *    Number of kernings
+    */
+    void referenceKernings(std::vector<std::uint32_t> && offsets, const std::uint32_t * indices, const std::int16_t * amounts, std::size_t count);
+
+    /**
+    *  @brief
+    *    Set kerning runs and storage, and update the kerning masks
+    *
+    *  @param[in] offsets
+    *    Begin of the kerning run by glyph id, followed by the end of the last run (empty if there are no kernings)
+    *  @param[in] indices
+    *    Subsequent glyph indices of all kernings
+    *  @param[in] amounts
+    *    Kerning amounts in 1/64 pt
+    *  @param[in] count
+    *    Number of kernings
+    */
+    void setKerningData(std::vector<std::uint32_t> && offsets, const std::uint32_t * indices, const std::int16_t * amounts, std::size_t count);
 
-private:
-    mutable std::tuple<size_t, size_t, float> m_kerningRequestCache;
+    /**
+    *  @brief
+    *    Copy kernings in external storage, so they can be modified
+    */
+    void detachKernings();
 };
 
 
@@ -2,10 +2,12 @@
 #pragma once
 
 
+#include <cstddef>
+#include <cstdint>
+#include <future>
 #include <memory>
-#include <iosfwd>
 #include <string>
-#include <map>
+#include <vector>
 
 #include <openll/openll_api.h>
 
@@ -29,92 +31,176 @@ public:
 
     /**
     *  @brief
-    *    Load a font face from a font description file (.fnt)
+    *    Load a font face from a font description file (.fnt) or binary font file (.llf)
+    *
+    *    The glyph texture atlas is loaded into main memory only (see
+    *    FontFace::glyphAtlas()), so no OpenGL context is required.
+    *    Binary font files (see FontWriter) are detected by their
+    *    contents and loaded without parsing.
     *
     *  @param[in] filename
-    *    Path to the font face description file (.fnt)
+    *    Path to the font face description file (.fnt) or binary font file (.llf)
     *
     *  @return
     *    A configured and initialized FontFace on success, else 'nullptr'
     */
     static std::unique_ptr<FontFace> load(const std::string & filename);
 
+    /**
+    *  @brief
+    *    Load a font face on a worker thread
+    *
+    *    Reading, parsing, and decoding of the glyph atlas happen on the
+    *    worker thread, as load() requires no OpenGL context. The glyph
+    *    texture is uploaded on the context's thread afterwards, either at
+    *    once on first access or spread over several frames (see
+    *    FontFace::uploadGlyphTexture()).
+    *
+    *  @param[in] filename
+    *    Path to the font face description file (.fnt) or binary font file (.llf)
+    *
+    *  @return
+    *    Future of the font face, 'nullptr' on failure (see load())
+    */
+    static std::future<std::unique_ptr<FontFace>> loadAsync(const std::string & filename);
+
+    /**
+    *  @brief
+    *    Load a font face from a binary font embedded in the executable
+    *
+    *    Embedded fonts are generated by openll-fontc (see the CMake
+    *    function openll_embed_font()) and loaded without file access
+    *    or parsing. The glyph atlas and the kernings reference the data
+    *    instead of copying it (until kernings are modified); only the
+    *    glyphs are copied, as they are converted into Glyph objects.
+    *
+    *  @param[in] data
+    *    Contents of the binary font (aligned to 16 bytes, has to outlive the font face)
+    *  @param[in] size
+    *    Size of the contents in bytes
+    *
+    *  @return
+    *    The loaded font face, 'nullptr' if the data is invalid or of another version or byte order
+    */
+    static std::unique_ptr<FontFace> loadEmbedded(const unsigned char * data, std::size_t size);
+
+    /**
+    *  @brief
+    *    Load a font face from the contents of a font description file (.fnt)
+    *
+    *    The contents are tokenized in place, without allocations per line,
+    *    so descriptions can be loaded from memory (e.g., from an archive).
+    *    Glyph texture atlases are read from the files listed in the
+    *    description.
+    *
+    *  @param[in] begin
+    *    First character of the description
+    *  @param[in] end
+    *    Character after the last character of the description
+    *  @param[in] filename
+    *    Path to the font face description file to derive glyph texture atlas file paths
+    *
+    *  @return
+    *    The loaded font face, 'nullptr' if no glyph texture atlas could be loaded
+    */
+    static std::unique_ptr<FontFace> loadDescription(const char * begin, const char * end, const std::string & filename);
+
 
 protected:
     /**
     *  @brief
-    *    Parse common info block of font face description file
+    *    Load a font face from the contents of a binary font file (.llf)
+    *
+    *  @param[in] data
+    *    Contents of the binary font file, usually memory-mapped
+    *  @param[in] size
+    *    Size of the contents in bytes
+    *  @param[in] reference
+    *    Reference the glyph atlas and kernings in the contents instead of copying them (contents have to outlive the font face)
     *
-    *  @param[in] stream
-    *    The stream to read info from
+    *  @return
+    *    The loaded font face, 'nullptr' if the file is invalid or of another version or byte order
+    */
+    static std::unique_ptr<FontFace> loadBinary(const unsigned char * data, std::size_t size, bool reference = false);
+
+    /**
+    *  @brief
+    *    Parse info block of font face description file
+    *
+    *  @param[in] begin
+    *    First character of the key-value pairs of the line
+    *  @param[in] end
+    *    End of the line
     *  @param[in,out] fontFace
     *    The font face to construct
     *  @param[out] fontSize
     *    The retrieved font size of the font face
     */
-    static void parseInfo(std::stringstream & stream, FontFace & fontFace, float & fontSize);
+    static void parseInfo(const char * begin, const char * end, FontFace & fontFace, float & fontSize);
 
     /**
     *  @brief
     *    Parse common block of font face description file
     *
-    *  @param[in] stream
-    *    The stream to read info from
+    *  @param[in] begin
+    *    First character of the key-value pairs of the line
+    *  @param[in] end
+    *    End of the line
     *  @param[in,out] fontFace
     *    The font face to construct
     *  @param[in] fontSize
     *    The font size to correctly determine other metrics
     */
-    static void parseCommon(std::stringstream & stream, FontFace & fontFace, float fontSize);
+    static void parseCommon(const char * begin, const char * end, FontFace & fontFace, float fontSize);
 
     /**
     *  @brief
     *    Parse font face page block of font face description file
     *
-    *  @param[in] stream
-    *    The stream to read info from
+    *  @param[in] begin
+    *    First character of the key-value pairs of the line
+    *  @param[in] end
+    *    End of the line
     *  @param[in,out] fontFace
     *    The font face to construct
-    *  @param[out] filename
+    *  @param[in] filename
     *    The file name of the description file to derivate glyph texture atlas file paths
     */
-    static void parsePage(std::stringstream & stream, FontFace & fontFace, const std::string & filename);
+    static void parsePage(const char * begin, const char * end, FontFace & fontFace, const std::string & filename);
 
     /**
     *  @brief
     *    Parse font face character block of font face description file
     *
-    *  @param[in] stream
-    *    The stream to read info from
+    *  @param[in] begin
+    *    First character of the key-value pairs of the line
+    *  @param[in] end
+    *    End of the line
     *  @param[in,out] fontFace
     *    The font face to construct
     */
-    static void parseChar(std::stringstream & stream, FontFace & fontFace);
+    static void parseChar(const char * begin, const char * end, FontFace & fontFace);
 
     /**
     *  @brief
     *    Parse font face kerning block of font face description file
     *
-    *  @param[in] stream
-    *    The stream to read info from
-    *  @param[in,out] fontFace
-    *    The font face to construct
-    */
-    static void parseKerning(std::stringstream & stream, FontFace & fontFace);
-
-    /**
-    *  @brief
-    *    Extract all key-value pairs of one line in the description file
-    *
-    *  @param[in] stream
-    *    The stream to read from
-    *  @param[in] mandatoryKeys
-    *    The list of mandatory keys required for successful extraction
+    *  @param[in] begin
+    *    First character of the key-value pairs of the line
+    *  @param[in] end
+    *    End of the line
+    *  @param[in,out] indices
+    *    Glyph indices of the kerning pairs, the parsed pair is appended
+    *  @param[in,out] subsequentIndices
+    *    Subsequent glyph indices of the kerning pairs, the parsed pair is appended
+    *  @param[in,out] kernings
+    *    Kerning amounts of the kerning pairs, the parsed pair is appended
     *
-    *  @return
-    *    The list of all extracted key-value pairs, empty if not all mandatory keys exist
+    *  @remarks
+    *    Kernings are collected and set at once after parsing (see FontFace::setKernings()).
     */
-    static std::map<std::string, std::string> readKeyValuePairs(std::stringstream & stream, const std::initializer_list<const char *> & mandatoryKeys);
+    static void parseKerning(const char * begin, const char * end
+        , std::vector<std::uint32_t> & indices, std::vector<std::uint32_t> & subsequentIndices, std::vector<float> & kernings);
 };
 
 
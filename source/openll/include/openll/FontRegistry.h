@@ -0,0 +1,206 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+class FontFace;
+
+
+/**
+*  @brief
+*    Cache of font faces that are shared by all users of the same font file
+*
+*    Font faces are loaded on first request (see FontLoader::load()) and
+*    identified by the canonical path of their file, so different paths to
+*    the same file share one font face. The registry hands out shared
+*    handles; labels keep referring to the font face itself (see
+*    Label::setFontFace()), so a handle has to be kept as long as labels
+*    use the font face.
+*
+*    Font faces that are no longer referenced outside the registry are kept
+*    until the memory usage of all cached font faces exceeds the memory
+*    budget. They are evicted in order of least recent request then.
+*
+*    All functions can be called concurrently. A font face that is
+*    requested by multiple threads at once is loaded only once, the other
+*    threads wait for it.
+*
+*    Evicting a font face destroys it, including its glyph texture once it
+*    has been uploaded. Functions that may evict (get(), setMemoryBudget(),
+*    and collect()) therefore have to be called on the thread of the
+*    OpenGL context if any glyph texture of the cached font faces has been
+*    created. The same applies to releasing the last handle of an evicted
+*    font face and to destroying the registry.
+*/
+class OPENLL_API FontRegistry
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] memoryBudget
+    *    Memory usage in bytes above which unreferenced font faces are evicted
+    */
+    explicit FontRegistry(std::size_t memoryBudget = 64 * 1024 * 1024);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *    Handles that are still held remain valid.
+    */
+    ~FontRegistry();
+
+    // Forbid copying
+    FontRegistry(const FontRegistry &) = delete;
+    FontRegistry & operator=(const FontRegistry &) = delete;
+
+    /**
+    *  @brief
+    *    Get a font face, loading it if it is not cached
+    *
+    *  @param[in] filename
+    *    Path to the font face description file (.fnt) or binary font file (.llf)
+    *
+    *  @return
+    *    Shared font face, 'nullptr' if it could not be loaded
+    *
+    *  @remarks
+    *    Failed loads are not cached, so a later request tries again.
+    *    Evicts unreferenced font faces if the memory budget is exceeded
+    *    (see class description for the thread requirements).
+    */
+    std::shared_ptr<FontFace> get(const std::string & filename);
+
+    /**
+    *  @brief
+    *    Check if a font face is cached
+    *
+    *  @param[in] filename
+    *    Path to the font face file
+    *
+    *  @return
+    *    'true' if the font face is loaded or being loaded, else 'false'
+    */
+    bool contains(const std::string & filename) const;
+
+    /**
+    *  @brief
+    *    Get number of cached font faces
+    *
+    *  @return
+    *    Number of font faces that are loaded or being loaded
+    */
+    std::size_t size() const;
+
+    /**
+    *  @brief
+    *    Get memory usage of all cached font faces
+    *
+    *    The memory usage of a font face is determined once it has been
+    *    loaded (see FontFace::memoryUsage()).
+    *
+    *  @return
+    *    Memory usage in bytes
+    */
+    std::size_t memoryUsage() const;
+
+    /**
+    *  @brief
+    *    Get memory budget
+    *
+    *  @return
+    *    Memory usage in bytes above which unreferenced font faces are evicted
+    */
+    std::size_t memoryBudget() const;
+
+    /**
+    *  @brief
+    *    Set memory budget
+    *
+    *    Evicts unreferenced font faces if the new budget is exceeded
+    *    (see class description for the thread requirements).
+    *
+    *  @param[in] memoryBudget
+    *    Memory usage in bytes above which unreferenced font faces are evicted
+    */
+    void setMemoryBudget(std::size_t memoryBudget);
+
+    /**
+    *  @brief
+    *    Evict all unreferenced font faces regardless of the memory budget
+    *
+    *    Has to be called on the thread of the OpenGL context if glyph
+    *    textures have been created (see class description).
+    *
+    *  @return
+    *    Number of evicted font faces
+    */
+    std::size_t collect();
+
+
+protected:
+    /**
+    *  @brief
+    *    Cached font face
+    */
+    struct Entry
+    {
+        std::shared_future<std::shared_ptr<FontFace>> face;        ///< Font face, not ready while being loaded
+        std::size_t                                   memoryUsage; ///< Memory usage of the font face in bytes (0 while being loaded)
+        std::uint64_t                                 lastAccess;  ///< Number of the last request of the font face
+    };
+
+    /**
+    *  @brief
+    *    Evict unreferenced font faces in order of least recent request
+    *
+    *  @param[in] memoryBudget
+    *    Memory usage in bytes to reach
+    *
+    *  @return
+    *    Number of evicted font faces
+    *
+    *  @remarks
+    *    Requires m_mutex to be locked.
+    */
+    std::size_t evict(std::size_t memoryBudget);
+
+    /**
+    *  @brief
+    *    Get the key of a font file
+    *
+    *  @param[in] filename
+    *    Path to the font face file
+    *
+    *  @return
+    *    Canonical path, or the given path if the file does not exist
+    */
+    static std::string canonicalPath(const std::string & filename);
+
+
+protected:
+    mutable std::mutex                     m_mutex;        ///< Synchronizes all accesses to the cache
+    std::unordered_map<std::string, Entry> m_entries;      ///< Cached font faces by canonical path
+    std::size_t                            m_memoryBudget; ///< Memory usage in bytes above which unreferenced font faces are evicted
+    std::size_t                            m_memoryUsage;  ///< Memory usage of all cached font faces in bytes
+    std::uint64_t                          m_accessCount;  ///< Number of requests so far
+};
+
+
+} // namespace openll
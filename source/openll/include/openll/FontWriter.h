@@ -0,0 +1,64 @@
+
+#pragma once
+
+
+#include <iosfwd>
+#include <string>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+class FontFace;
+
+/**
+*  @brief
+*    Writer that stores font faces as precompiled binary font files (.llf)
+*
+*    Binary font files contain the metrics, glyphs, kernings, and the glyph
+*    atlas of a font face. They are loaded by FontLoader without parsing.
+*    The files are not portable between machines of different byte order.
+*/
+class OPENLL_API FontWriter
+{
+public:
+    FontWriter() = delete;
+    ~FontWriter() = delete;
+
+    /**
+    *  @brief
+    *    Write a font face to a binary font file (.llf)
+    *
+    *  @param[in] fontFace
+    *    Font face to write
+    *  @param[in] filename
+    *    Path to the binary font file
+    *
+    *  @return
+    *    'true' if the file was written, else 'false'
+    */
+    static bool write(const FontFace & fontFace, const std::string & filename);
+
+    /**
+    *  @brief
+    *    Write a font face in the binary font format to a stream
+    *
+    *    Section offsets are relative to the current position of the
+    *    stream, which has to support tellp().
+    *
+    *  @param[in] fontFace
+    *    Font face to write
+    *  @param[in] out
+    *    Binary output stream
+    *
+    *  @return
+    *    'true' if the font face was written, else 'false'
+    */
+    static bool write(const FontFace & fontFace, std::ostream & out);
+};
+
+
+} // namespace openll
@@ -0,0 +1,158 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    CPU-side image of a glyph texture atlas
+*
+*    Holds the pixels of the glyph texture atlas in main memory, so
+*    font faces can be loaded without an OpenGL context. The GPU
+*    texture is created from the atlas on demand (see FontFace::glyphTexture()).
+*    Rows are stored bottom-up, as expected by OpenGL, without padding.
+*
+*    The pixels are either owned by the atlas or reference external
+*    storage that outlives it (e.g., of a font embedded in the executable).
+*/
+class OPENLL_API GlyphAtlas
+{
+public:
+    /**
+    *  @brief
+    *    Pixel format
+    */
+    enum class Format : unsigned char
+    {
+        R8,    ///< Single channel (e.g., distance field), 8 bit
+        RGBA8  ///< Four channels, 8 bit each
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *    Constructs an empty atlas.
+    */
+    GlyphAtlas();
+
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] extent
+    *    Width and height in px
+    *  @param[in] format
+    *    Pixel format
+    *  @param[in] pixels
+    *    Pixel data (size has to match the extent and format)
+    */
+    GlyphAtlas(const glm::uvec2 & extent, Format format, std::vector<unsigned char> && pixels);
+
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *    References the pixels without copying them.
+    *
+    *  @param[in] extent
+    *    Width and height in px
+    *  @param[in] format
+    *    Pixel format
+    *  @param[in] pixels
+    *    Pixel data matching the extent and format (has to outlive the atlas)
+    */
+    GlyphAtlas(const glm::uvec2 & extent, Format format, const unsigned char * pixels);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~GlyphAtlas();
+
+    /**
+    *  @brief
+    *    Check if the atlas contains pixels
+    *
+    *  @return
+    *    'true' if the atlas is empty, else 'false'
+    */
+    bool empty() const;
+
+    /**
+    *  @brief
+    *    Check if the pixels are stored externally
+    *
+    *  @return
+    *    'true' if the atlas references external pixel data, 'false' if it owns its pixels
+    */
+    bool external() const;
+
+    /**
+    *  @brief
+    *    Get extent
+    *
+    *  @return
+    *    Width and height in px
+    */
+    const glm::uvec2 & extent() const;
+
+    /**
+    *  @brief
+    *    Get pixel format
+    *
+    *  @return
+    *    Pixel format
+    */
+    Format format() const;
+
+    /**
+    *  @brief
+    *    Get size of a pixel
+    *
+    *  @return
+    *    Number of bytes per pixel
+    */
+    std::size_t bytesPerPixel() const;
+
+    /**
+    *  @brief
+    *    Get pixel data
+    *
+    *  @return
+    *    Pixels, row by row ('nullptr' if empty)
+    */
+    const unsigned char * data() const;
+
+    /**
+    *  @brief
+    *    Get size of the pixel data
+    *
+    *  @return
+    *    Number of bytes of all pixels
+    */
+    std::size_t size() const;
+
+
+protected:
+    glm::uvec2                  m_extent;   ///< Width and height in px
+    Format                      m_format;   ///< Pixel format
+    std::vector<unsigned char>  m_pixels;   ///< Owned pixel data
+    const unsigned char       * m_external; ///< External pixel data (nullptr if owned)
+};
+
+
+} // namespace openll
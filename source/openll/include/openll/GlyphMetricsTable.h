@@ -0,0 +1,141 @@
+
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+class Glyph;
+
+/**
+*  @brief
+*    Packed glyph metrics of a font face for typesetting
+*
+*    Holds the metrics the typesetter needs per glyph in separate,
+*    contiguous arrays (structure of arrays), indexed by the dense
+*    glyph id of the font face (see FontFace::glyphId()). So the
+*    typesetter only loads the data it actually uses, instead of
+*    the complete, editable Glyph objects. Id 0 refers to the empty
+*    glyph used for missing glyphs.
+*
+*    The table is maintained by the font face. Glyph objects remain
+*    the interface for authoring glyphs.
+*/
+class OPENLL_API GlyphMetricsTable
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    GlyphMetricsTable();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~GlyphMetricsTable();
+
+    /**
+    *  @brief
+    *    Get number of glyphs
+    *
+    *  @return
+    *    Number of glyphs, including the empty glyph
+    */
+    std::size_t size() const;
+
+    /**
+    *  @brief
+    *    Set number of glyphs
+    *
+    *    Added glyphs have zero metrics and are not depictable.
+    *
+    *  @param[in] size
+    *    Number of glyphs, including the empty glyph
+    */
+    void resize(std::size_t size);
+
+    /**
+    *  @brief
+    *    Update the metrics of a glyph
+    *
+    *  @param[in] id
+    *    Dense id of the glyph (has to be less than size())
+    *  @param[in] glyph
+    *    Glyph to take the metrics from
+    *
+    *  @return
+    *    'true' if the metrics of the glyph changed, else 'false'
+    */
+    bool setGlyph(std::uint32_t id, const Glyph & glyph);
+
+    /**
+    *  @brief
+    *    Get horizontal advances in pt
+    *
+    *  @return
+    *    Advance by glyph id
+    */
+    const std::vector<float> & advances() const;
+
+    /**
+    *  @brief
+    *    Get depictable flags
+    *
+    *  @return
+    *    1 if the glyph is depictable, else 0, by glyph id
+    */
+    const std::vector<std::uint8_t> & depictables() const;
+
+    /**
+    *  @brief
+    *    Get pen rectangles
+    *
+    *    The pen rectangle packs the pen origin (x, y), the length
+    *    of the pen tangent (z) and of the pen bitangent (w), see
+    *    Glyph::penOrigin(), Glyph::penTangent(), and Glyph::penBitangent().
+    *
+    *  @return
+    *    Pen rectangle by glyph id
+    */
+    const std::vector<glm::vec4> & penRectangles() const;
+
+    /**
+    *  @brief
+    *    Get sub-texture rectangles
+    *
+    *  @return
+    *    Sub-texture rectangle (see Glyph::subtextureRectangle()) by glyph id
+    */
+    const std::vector<glm::vec4> & subtextureRectangles() const;
+
+    /**
+    *  @brief
+    *    Get glyph indices
+    *
+    *  @return
+    *    Glyph index (code point) by glyph id
+    */
+    const std::vector<std::uint32_t> & indices() const;
+
+
+protected:
+    std::vector<float>         m_advances;             ///< Horizontal advance in pt by glyph id
+    std::vector<std::uint8_t>  m_depictables;          ///< Depictable flag by glyph id
+    std::vector<glm::vec4>     m_penRectangles;        ///< Pen origin and tangent/bitangent lengths by glyph id
+    std::vector<glm::vec4>     m_subtextureRectangles; ///< Sub-texture rectangle by glyph id
+    std::vector<std::uint32_t> m_indices;              ///< Glyph index by glyph id
+};
+
+
+} // namespace openll
@@ -2,7 +2,9 @@
 #pragma once
 
 
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 #include <glm/fwd.hpp>
 
@@ -30,6 +32,21 @@ class GlyphVertexCloud;
 */
 class OPENLL_API GlyphRenderer
 {
+public:
+    /**
+    *  @brief
+    *    Number of OpenGL state changes and draw calls issued to render a list of vertex clouds
+    */
+    struct Statistics
+    {
+        std::size_t numVertexClouds;       ///< Number of rendered (non-empty) vertex clouds
+        std::size_t numDrawCalls;          ///< Number of draw calls (a multi-draw call counts once)
+        std::size_t numProgramChanges;     ///< Number of times the shader program has been bound
+        std::size_t numTextureChanges;     ///< Number of times a glyph texture has been bound
+        std::size_t numVertexArrayChanges; ///< Number of times a vertex array has been bound
+    };
+
+
 public:
     /**
     *  @brief
@@ -125,6 +142,41 @@ public:
     */
     void renderInWorld(const GlyphVertexCloud & vertexCloud, const glm::mat4 & viewProjectionMatrix) const;
 
+    /**
+    *  @brief
+    *    Render text of several vertex clouds to screen in 2D space
+    *
+    *    See renderInWorld(const std::vector<const GlyphVertexCloud *> &, const glm::mat4 &).
+    *
+    *  @param[in] vertexClouds
+    *    Glyph vertex arrays (must not be null)
+    *
+    *  @return
+    *    Number of state changes and draw calls
+    */
+    Statistics render(const std::vector<const GlyphVertexCloud *> & vertexClouds) const;
+
+    /**
+    *  @brief
+    *    Render text of several vertex clouds to screen in 3D world space
+    *
+    *    The vertex clouds are grouped by glyph texture and vertex array,
+    *    so the program is bound once and each texture and vertex array
+    *    once per group. Vertex clouds that are stored in the same page of
+    *    a GlyphVertexArena share their vertex array and are drawn by a
+    *    single multi-draw call. The order in which vertex clouds are drawn
+    *    is not preserved.
+    *
+    *  @param[in] vertexClouds
+    *    Glyph vertex arrays (must not be null)
+    *  @param[in] viewProjectionMatrix
+    *    View-projection matrix of the current camera
+    *
+    *  @return
+    *    Number of state changes and draw calls
+    */
+    Statistics renderInWorld(const std::vector<const GlyphVertexCloud *> & vertexClouds, const glm::mat4 & viewProjectionMatrix) const;
+
 
 protected:
     std::unique_ptr<globjects::AbstractStringSource> m_vertexShaderSource;   ///< Shader source for the vertex shader
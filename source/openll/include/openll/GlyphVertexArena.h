@@ -0,0 +1,207 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <openll/openll_api.h>
+
+
+namespace globjects
+{
+    class Buffer;
+    class VertexArray;
+}
+
+
+namespace openll
+{
+
+
+class ArenaAllocator;
+
+
+/**
+*  @brief
+*    Shared GPU storage for the vertices of many glyph vertex clouds
+*
+*    Vertex clouds created for an arena (see GlyphVertexCloud) do not own
+*    a buffer and vertex array object, but a range of vertices within one
+*    of a few large buffers (pages). Each page has a single vertex array
+*    object, which is shared by all clouds allocated from that page, so
+*    drawing them only changes the first vertex of the draw call.
+*
+*    Ranges are managed by an allocator per page. If no page has a free
+*    range that is large enough, a new page is created. A page whose last
+*    range is freed is kept for reuse, so vertex clouds that are recreated
+*    on each frame do not recreate OpenGL objects. Only a single empty page
+*    is kept, further empty pages and pages larger than the page capacity
+*    are deleted right away (see also trim()). The index of a deleted page
+*    is reused by the next page that is created, indices of other pages do
+*    not change.
+*/
+class OPENLL_API GlyphVertexArena
+{
+public:
+    static const std::size_t invalidPage; ///< Page of an empty allocation
+
+
+public:
+    /**
+    *  @brief
+    *    Range of vertices within a page
+    */
+    struct Allocation
+    {
+        std::size_t page;   ///< Index of the page (invalidPage if empty)
+        std::size_t offset; ///< Index of the first vertex within the page
+        std::size_t size;   ///< Number of vertices
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] pageCapacity
+    *    Number of vertices per page
+    *
+    *  @remarks
+    *    Pages are allocated on demand, so no OpenGL context is required when creating this object.
+    */
+    explicit GlyphVertexArena(std::size_t pageCapacity = 65536);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    This deletes OpenGL objects, so an OpenGL context must be current when deleting this object.
+    *    All vertex clouds created for this arena have to be deleted before.
+    */
+    ~GlyphVertexArena();
+
+    // Forbid copying
+    GlyphVertexArena(const GlyphVertexArena &) = delete;
+    GlyphVertexArena & operator=(const GlyphVertexArena &) = delete;
+
+    /**
+    *  @brief
+    *    Allocate a range of vertices
+    *
+    *  @param[in] size
+    *    Number of vertices
+    *
+    *  @return
+    *    Allocated range, empty if size is 0
+    *
+    *  @remarks
+    *    Ranges larger than the page capacity get a page of their own.
+    *    Creating a page allocates OpenGL objects, so an OpenGL context must be current.
+    */
+    Allocation allocate(std::size_t size);
+
+    /**
+    *  @brief
+    *    Free a range of vertices
+    *
+    *  @param[in] allocation
+    *    Range returned by allocate()
+    *
+    *  @remarks
+    *    Freeing the last range of a page may delete the page, so an OpenGL context must be current.
+    */
+    void free(const Allocation & allocation);
+
+    /**
+    *  @brief
+    *    Delete all pages without allocations
+    *
+    *  @remarks
+    *    This deletes OpenGL objects, so an OpenGL context must be current.
+    */
+    void trim();
+
+    /**
+    *  @brief
+    *    Get number of vertices per page
+    *
+    *  @return
+    *    Page capacity
+    */
+    std::size_t pageCapacity() const;
+
+    /**
+    *  @brief
+    *    Get number of pages
+    *
+    *  @return
+    *    Number of pages, including an empty page kept for reuse
+    */
+    std::size_t numPages() const;
+
+    /**
+    *  @brief
+    *    Get vertex buffer of a page
+    *
+    *  @param[in] page
+    *    Index of a page that holds allocations
+    *
+    *  @return
+    *    Vertex buffer
+    */
+    globjects::Buffer * buffer(std::size_t page);
+
+    /**
+    *  @brief
+    *    Get vertex array of a page
+    *
+    *  @param[in] page
+    *    Index of a page that holds allocations
+    *
+    *  @return
+    *    Vertex array
+    */
+    const globjects::VertexArray * vao(std::size_t page) const;
+
+    /**
+    *  @brief
+    *    Get vertex array of a page
+    *
+    *  @param[in] page
+    *    Index of a page that holds allocations
+    *
+    *  @return
+    *    Vertex array
+    */
+    globjects::VertexArray * vao(std::size_t page);
+
+
+protected:
+    /**
+    *  @brief
+    *    Vertex buffer with its vertex array object and allocator
+    */
+    struct Page
+    {
+        explicit Page(std::size_t capacity);
+        ~Page();
+
+        bool empty() const;
+
+        std::unique_ptr<globjects::Buffer>      buffer;    ///< Vertex buffer (GPU memory)
+        std::unique_ptr<globjects::VertexArray> vao;       ///< Vertex array object
+        std::unique_ptr<ArenaAllocator>         allocator; ///< Allocated ranges of the vertex buffer
+    };
+
+
+protected:
+    std::size_t                        m_pageCapacity; ///< Number of vertices per page
+    std::vector<std::unique_ptr<Page>> m_pages;        ///< Pages
+};
+
+
+} // namespace openll
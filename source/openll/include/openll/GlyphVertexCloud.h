@@ -2,6 +2,9 @@
 #pragma once
 
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -9,12 +12,14 @@
 #include <glm/vec4.hpp>
 
 #include <openll/openll_api.h>
+#include <openll/GlyphVertexArena.h>
 
 
 namespace globjects
 {
     class Texture;
     class Buffer;
+    class Sync;
     class VertexArray;
 }
 
@@ -23,12 +28,34 @@ namespace openll
 {
 
 
+class DirtyRanges;
+class FontFace;
+class StreamSegments;
+class UpdateFrequency;
+
+
 /**
 *  @brief
 *    Vertex array that describes each glyph to be rendered on the screen
+*
+*    By default, the vertices are kept in CPU memory (see vertices()) and
+*    uploaded on update(). For text that changes on every frame, a
+*    streaming vertex cloud writes the vertices directly into one of
+*    numStreamSegments segments of a persistently mapped buffer (see
+*    beginStream()). Segments are reused in turn once the GPU has finished
+*    drawing them, so neither copies nor implicit synchronization occur.
+*    Streaming requires OpenGL 4.4 or ARB_buffer_storage.
+*
+*    Many small vertex clouds can share their GPU storage by means of a
+*    GlyphVertexArena. Such a vertex cloud owns a range of vertices of the
+*    arena instead of its own buffer and vertex array object.
 */
 class OPENLL_API GlyphVertexCloud
 {
+public:
+    static const std::size_t numStreamSegments = 3; ///< Number of segments of a streaming vertex cloud
+
+
 public:
     /**
     *  @brief
@@ -43,6 +70,30 @@ public:
         glm::vec4 textColor; ///< Text of the glyph
     };
 
+    /**
+    *  @brief
+    *    Compact data for a single vertex (glyph) in GPU memory
+    *
+    *    Tangent and bitangent are stored as half floats, the uv-rect as
+    *    normalized 16 bit and the text color as normalized 8 bit integers,
+    *    which the vertex shader receives as floats. This reduces a vertex
+    *    from 64 to 40 bytes. The origin keeps full precision.
+    */
+    struct PackedVertex
+    {
+        glm::vec3     origin;       ///< Position of the glyph in normalized device coordinates
+        std::uint8_t  textColor[4]; ///< Text color of the glyph (normalized rgba)
+        std::uint16_t vtan[4];      ///< Tangent vector (half floats, last component unused)
+        std::uint16_t vbitan[4];    ///< Bitangent vector (half floats, last component unused)
+        std::uint16_t uvRect[4];    ///< Source image rect of the glyph in the glyph texture (normalized uv-coordinates)
+    };
+
+#ifdef OPENLL_COMPACT_VERTICES
+    using GPUVertex = PackedVertex; ///< Vertex format in GPU memory, selected by OPTION_COMPACT_VERTICES
+#else
+    using GPUVertex = Vertex;       ///< Vertex format in GPU memory, selected by OPTION_COMPACT_VERTICES
+#endif
+
 
 public:
     /**
@@ -54,6 +105,30 @@ public:
     */
     GlyphVertexCloud();
 
+    /**
+    *  @brief
+    *    Constructor of a streaming vertex cloud
+    *
+    *  @param[in] streamCapacity
+    *    Maximum number of vertices per frame
+    *
+    *  @remarks
+    *    This allocates and maps OpenGL objects, so an OpenGL context must be current when creating this object.
+    */
+    explicit GlyphVertexCloud(std::size_t streamCapacity);
+
+    /**
+    *  @brief
+    *    Constructor of a vertex cloud that is stored in an arena
+    *
+    *  @param[in] arena
+    *    Arena that provides the GPU storage (must outlive this object)
+    *
+    *  @remarks
+    *    Vertices are allocated from the arena on update(), so an OpenGL context must be current then.
+    */
+    explicit GlyphVertexCloud(GlyphVertexArena & arena);
+
     /**
     *  @brief
     *    Destructor
@@ -66,6 +141,17 @@ public:
     // Forbid copying
     GlyphVertexCloud & operator=(const GlyphVertexCloud &) = delete;
 
+    /**
+    *  @brief
+    *    Get number of vertices to draw
+    *
+    *  @return
+    *    Number of vertices uploaded by the last update() (bounded by the
+    *    allocated range of an arena), or number of vertices of the current
+    *    segment if streaming
+    */
+    std::size_t size() const;
+
     /**
     *  @brief
     *    Get vertices (in CPU memory)
@@ -89,7 +175,7 @@ public:
     *    Get vertex array
     *
     *  @return
-    *    Vertex array
+    *    Vertex array, 'nullptr' if stored in an arena and not yet uploaded
     */
     const globjects::VertexArray * vao() const;
 
@@ -98,16 +184,40 @@ public:
     *    Get vertex array
     *
     *  @return
-    *    Vertex array
+    *    Vertex array, 'nullptr' if stored in an arena and not yet uploaded
     */
     globjects::VertexArray * vao();
 
+    /**
+    *  @brief
+    *    Get arena that stores the vertices
+    *
+    *  @return
+    *    Arena, 'nullptr' if the vertex cloud owns its buffer
+    */
+    const GlyphVertexArena * arena() const;
+
+    /**
+    *  @brief
+    *    Get range of the arena that stores the vertices
+    *
+    *  @return
+    *    Allocated range, empty if not stored in an arena
+    */
+    const GlyphVertexArena::Allocation & allocation() const;
+
     /**
     *  @brief
     *    Get glyph texture for which the text has been layouted
     *
+    *    If no texture has been set explicitly, the glyph texture of the
+    *    font face is resolved on each call, so rows of the glyph atlas
+    *    that are not yet uploaded (see FontFace::uploadGlyphTexture())
+    *    are uploaded at once. This requires the OpenGL context and is
+    *    meant to be called when rendering.
+    *
     *  @return
-    *    Glyph texture
+    *    Glyph texture, 'nullptr' if neither a texture nor a font face is set
     */
     const globjects::Texture * texture() const;
 
@@ -115,20 +225,63 @@ public:
     *  @brief
     *    Set glyph texture for which the text has been layouted
     *
+    *    The texture takes precedence over the font face's glyph texture.
+    *
     *  @param[in] texture
     *    Glyph texture
     */
     void setTexture(globjects::Texture * texture);
 
+    /**
+    *  @brief
+    *    Get font face for which the text has been layouted
+    *
+    *  @return
+    *    Font face, 'nullptr' if none is set
+    */
+    const FontFace * fontFace() const;
+
+    /**
+    *  @brief
+    *    Set font face for which the text has been layouted
+    *
+    *    The glyph texture of the font face is used for rendering (see
+    *    texture()). Setting the font face requires no OpenGL context,
+    *    so typesetting does not upload the glyph texture.
+    *
+    *  @param[in] fontFace
+    *    Font face (has to outlive the vertex cloud or be reset)
+    */
+    void setFontFace(const FontFace * fontFace);
+
+    /**
+    *  @brief
+    *    Mark a range of the vertex list as modified
+    *
+    *    The next call of update() uploads only the marked ranges.
+    *
+    *  @param[in] first
+    *    Index of the first modified vertex
+    *  @param[in] count
+    *    Number of modified vertices
+    */
+    void markDirty(std::size_t first, std::size_t count);
+
     /**
     *  @brief
     *    Update VAO
     *
-    *    Uploads the contents of the vertex list (see vao())
-    *    onto the VAO on the GPU.
+    *    Uploads the contents of the vertex list (see vertices())
+    *    onto the VAO on the GPU. If ranges have been marked as modified
+    *    (see markDirty()), only these ranges and vertices appended since
+    *    the last update are uploaded, else the entire vertex list.
     *
-    *  @param[in] texture
-    *    Glyph texture
+    *    The GPU buffer grows geometrically and is only reallocated if
+    *    the vertex list exceeds its capacity, which uploads all vertices.
+    *    Once the vertex cloud has been updated in most of the recently
+    *    drawn frames, the buffer is reallocated a single time with a
+    *    dynamic usage hint, regardless of its size. A vertex cloud stored in an arena
+    *    grows by moving to a larger range of the arena instead.
     */
     void update();
 
@@ -136,7 +289,7 @@ public:
     *  @brief
     *    Update VAO
     *
-    *    Uploads the contents of the vertex list (see vao())
+    *    Uploads the contents of the given vertex list
     *    onto the VAO on the GPU.
     *
     *  @param[in] vertices
@@ -144,6 +297,97 @@ public:
     */
     void update(const std::vector<Vertex> & vertices);
 
+    /**
+    *  @brief
+    *    Update a range of the VAO
+    *
+    *    Uploads a range of the vertex list (see vertices())
+    *    onto the VAO on the GPU immediately, leaving all other vertices untouched.
+    *
+    *  @param[in] first
+    *    Index of the first vertex to upload
+    *  @param[in] count
+    *    Number of vertices to upload
+    *
+    *  @remarks
+    *    The GPU buffer is not resized, so the range has to be within the
+    *    vertices uploaded by the last update().
+    */
+    void update(std::size_t first, std::size_t count);
+
+    /**
+    *  @brief
+    *    Check if the vertex cloud streams its vertices
+    *
+    *  @return
+    *    'true' if created with a stream capacity, else 'false'
+    */
+    bool isStreaming() const;
+
+    /**
+    *  @brief
+    *    Get maximum number of vertices per frame of a streaming vertex cloud
+    *
+    *  @return
+    *    Number of vertices per segment, 0 if not streaming
+    */
+    std::size_t streamCapacity() const;
+
+    /**
+    *  @brief
+    *    Start writing the vertices of a new frame
+    *
+    *    Switches to the next segment, waiting until the GPU has finished
+    *    drawing from it, if necessary.
+    *
+    *  @return
+    *    Vertices of the segment (capacity of streamCapacity()) to be written
+    *
+    *  @remarks
+    *    The vertices point into write-combined GPU memory if compact
+    *    vertices are disabled, so they should be written sequentially and
+    *    not be read. With compact vertices, they point into CPU memory and
+    *    are packed on endStream().
+    */
+    Vertex * beginStream();
+
+    /**
+    *  @brief
+    *    Finish writing the vertices of a frame
+    *
+    *  @param[in] count
+    *    Number of vertices written (at most streamCapacity())
+    */
+    void endStream(std::size_t count);
+
+    /**
+    *  @brief
+    *    Convert vertices to the compact vertex format
+    *
+    *    Used to upload vertices if compact vertices are enabled. Can be
+    *    used to keep typeset vertices in the compact format as well
+    *    (see Typesetter::VertexSink).
+    *
+    *  @param[in] vertices
+    *    Pointer to the first vertex
+    *  @param[in] count
+    *    Number of vertices
+    *  @param[out] packed
+    *    Pointer to the first packed vertex (capacity of at least count)
+    */
+    static void pack(const Vertex * vertices, std::size_t count, PackedVertex * packed);
+
+    /**
+    *  @brief
+    *    Setup the attribute bindings of a vertex array object for the GPU vertex format
+    *
+    *  @param[in] vao
+    *    Vertex array object
+    *  @param[in] buffer
+    *    Vertex buffer that contains vertices in the GPU vertex format
+    */
+    static void setupVertexArray(globjects::VertexArray & vao, globjects::Buffer & buffer);
+
     /**
     *  @brief
     *    Draw glyph vertex array
@@ -153,15 +397,65 @@ public:
     *    process for text rendering, such as binding the glyph texture
     *    or shader programs. Thus, the rendering has to be setup before
     *    calling this function (see GlyphRenderer).
+    *
+    *    Only the vertices uploaded by the last update() are drawn (see
+    *    size()). A streaming vertex cloud draws the current segment and marks
+    *    the segment as in use by the GPU.
     */
     void draw() const;
 
 
 protected:
-    std::vector<Vertex>                       m_vertices; ///< Vertex list (CPU memory)
-    std::unique_ptr<globjects::Buffer>        m_buffer;   ///< Vertex buffer (GPU memory)
-    std::unique_ptr<globjects::VertexArray>   m_vao;      ///< Vertex array object
-    globjects::Texture                      * m_texture;  ///< Glyph texture
+    /**
+    *  @brief
+    *    Ensure that the GPU buffer can hold a number of vertices
+    *
+    *    Reallocates the buffer (or the range of the arena) with at least
+    *    twice its capacity if it is too small, which discards its contents.
+    *    An owned buffer is also reallocated, with its current capacity,
+    *    when it switches to a dynamic usage hint.
+    *
+    *  @param[in] size
+    *    Number of vertices
+    *
+    *  @return
+    *    'true' if the buffer has been reallocated, else 'false'
+    */
+    bool reserve(std::size_t size);
+
+    /**
+    *  @brief
+    *    Upload vertices in the GPU vertex format
+    *
+    *  @param[in] vertices
+    *    Pointer to the first vertex
+    *  @param[in] count
+    *    Number of vertices
+    *  @param[in] first
+    *    Index of the first vertex in the buffer
+    */
+    void upload(const Vertex * vertices, std::size_t count, std::size_t first);
+
+
+protected:
+    std::vector<Vertex>                       m_vertices;       ///< Vertex list (CPU memory)
+    std::vector<PackedVertex>                 m_packed;         ///< Packed vertices to be uploaded (if compact vertices are enabled)
+    std::unique_ptr<DirtyRanges>              m_dirtyRanges;    ///< Modified ranges of the vertex list
+    std::size_t                               m_capacity;       ///< Number of vertices the vertex buffer can hold
+    std::size_t                               m_uploadedSize;   ///< Number of vertices uploaded to the vertex buffer
+    std::unique_ptr<UpdateFrequency>          m_frequency;      ///< Frequency of updates of the vertex list
+    bool                                      m_dynamic;        ///< Has the buffer been allocated with a dynamic usage hint?
+    std::unique_ptr<globjects::Buffer>        m_buffer;         ///< Vertex buffer (GPU memory)
+    std::unique_ptr<globjects::VertexArray>   m_vao;            ///< Vertex array object
+    globjects::Texture                      * m_texture;        ///< Glyph texture (set explicitly)
+    const FontFace                          * m_fontFace;       ///< Font face whose glyph texture is used if no texture is set
+
+    std::unique_ptr<StreamSegments>           m_streamSegments; ///< Segments of the mapped vertex buffer (without segments if not streaming)
+    GPUVertex                               * m_streamData;     ///< Persistently mapped vertex buffer
+    mutable std::array<std::unique_ptr<globjects::Sync>, numStreamSegments> m_streamFences; ///< Fences that signal when the GPU has finished drawing each segment
+
+    GlyphVertexArena                        * m_arena;          ///< Arena that stores the vertices (nullptr if the buffer is owned)
+    GlyphVertexArena::Allocation              m_allocation;     ///< Range of the arena that stores the vertices
 };
 
 
@@ -0,0 +1,171 @@
+
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/GlyphVertexCloud.h>
+#include <openll/LabelLayout.h>
+
+
+namespace openll
+{
+
+
+class Label;
+
+
+/**
+*  @brief
+*    Typesetter that keeps the layout of a list of labels and only
+*    re-typesets labels that have changed
+*
+*    The incremental typesetter owns no labels, but remembers the
+*    vertex range (slot) of each label within the vertex cloud as well
+*    as the state of the label at the time it was typeset (see
+*    Label::generation() and Text::generation()). On each call of
+*    typeset(), only labels that have changed since the previous call
+*    are typeset and only their vertex ranges are uploaded to the GPU.
+*    The layout of each label is kept as well (see LabelLayout), so a
+*    label that has only been moved or recolored is not re-layouted.
+*
+*    A label that needs fewer vertices than before is typeset into its
+*    slot, and the remaining vertices of the slot are cleared. A label
+*    that needs more vertices is moved to a new slot at the end of the
+*    vertex cloud. Once more than half of the vertices are unused, all
+*    slots are compacted and the vertex cloud is uploaded entirely.
+*/
+class OPENLL_API IncrementalTypesetter
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] vertexCloud
+    *    Vertex cloud that is maintained by the typesetter (must outlive the typesetter, must not be streaming)
+    *
+    *  @remarks
+    *    The vertex cloud must not be modified by others while used
+    *    by the incremental typesetter.
+    */
+    IncrementalTypesetter(GlyphVertexCloud & vertexCloud);
+
+    /**
+    *  @brief
+    *    Constructor of a typesetter that maintains a vertex list in CPU memory only
+    *
+    *  @param[in] vertices
+    *    Vertex list that is maintained by the typesetter (must outlive the typesetter)
+    *
+    *  @remarks
+    *    Nothing is uploaded, so no OpenGL context is required.
+    */
+    explicit IncrementalTypesetter(std::vector<GlyphVertexCloud::Vertex> & vertices);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~IncrementalTypesetter();
+
+    // Forbid copying
+    IncrementalTypesetter & operator=(const IncrementalTypesetter &) = delete;
+
+    /**
+    *  @brief
+    *    Typeset (layout) the given labels, re-using the layout of unchanged labels
+    *
+    *  @param[in] labels
+    *    List of labels to display
+    *
+    *  @return
+    *    Extent of the labels (in output space)
+    *
+    *  @notes
+    *    - Before calling this function, a valid font face has to be set on the label.
+    *    - Each label has to use the same font face (see Typesetter::typeset()).
+    *    - Labels are identified by their index within the list.
+    */
+    glm::vec2 typeset(const std::vector<Label> & labels);
+
+    /**
+    *  @brief
+    *    Get vertex ranges of the labels
+    *
+    *  @return
+    *    The indices of the labels in the resulting attributed vertex cloud
+    *
+    *  @remarks
+    *    A slot may be larger than the range of its label,
+    *    the remaining vertices of the slot are cleared.
+    */
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>> & positions() const;
+
+    /**
+    *  @brief
+    *    Get number of labels that have been typeset in the last call of typeset()
+    *
+    *  @return
+    *    Number of changed labels
+    */
+    std::size_t numChangedLabels() const;
+
+    /**
+    *  @brief
+    *    Forget all labels and clear the vertex cloud
+    *
+    *    The next call of typeset() will typeset all labels.
+    */
+    void clear();
+
+
+protected:
+    /**
+    *  @brief
+    *    Vertex range and typeset state of a single label
+    */
+    struct Slot
+    {
+        Slot() : capacity(0), generation(0), extent(0.0f, 0.0f) {}
+
+        std::uint32_t capacity;   ///< Number of vertices reserved for the label
+        std::uint64_t generation; ///< Generation of the label when it was typeset
+        LabelLayout   layout;     ///< Layout of the label (in font face space)
+        glm::vec2     extent;     ///< Extent of the label (in output space)
+    };
+
+    /**
+    *  @brief
+    *    Clear a range of vertices, so they are not rendered
+    *
+    *  @param[in] begin
+    *    Index of first vertex
+    *  @param[in] end
+    *    Index behind last vertex
+    */
+    void clearVertices(std::size_t begin, std::size_t end);
+
+    /**
+    *  @brief
+    *    Move all slots to the front of the vertex cloud, removing unused vertices
+    */
+    void compact();
+
+
+protected:
+    GlyphVertexCloud                                      * m_vertexCloud;  ///< The maintained vertex cloud (nullptr if only the vertex list is maintained)
+    std::vector<GlyphVertexCloud::Vertex>                 & m_vertices;     ///< The maintained vertex list
+    std::vector<Slot>                                       m_slots;        ///< Slot of each label
+    std::vector<std::pair<std::uint32_t, std::uint32_t>>    m_positions;    ///< Vertex range of each label
+    std::vector<std::pair<std::size_t, std::size_t>>        m_dirtyRanges;  ///< Vertex ranges that need to be uploaded
+    std::vector<GlyphVertexCloud::Vertex>                   m_scratch;      ///< Vertices of the label that is currently typeset
+    std::size_t                                             m_numUnused;    ///< Number of vertices that belong to no label
+    std::size_t                                             m_numChanged;   ///< Number of labels typeset in the last call
+};
+
+
+} // namespace openll
@@ -2,6 +2,7 @@
 #pragma once
 
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,6 +22,7 @@ namespace openll
 
 class Text;
 class FontFace;
+class LineBreakTable;
 
 
 /**
@@ -142,6 +144,28 @@ public:
     */
     void setLineWidth(float lineWidth);
 
+    /**
+    *  @brief
+    *    Get line break table used for word wrapping
+    *
+    *  @return
+    *    Line break classes of the characters (LineBreakTable::defaultTable() unless set)
+    */
+    const LineBreakTable & lineBreakTable() const;
+
+    /**
+    *  @brief
+    *    Set line break table used for word wrapping
+    *
+    *  @param[in] lineBreakTable
+    *    Line break classes of the characters (must outlive the label)
+    *
+    *  @remarks
+    *    Like the font face, the table is referenced, not copied. Set
+    *    it again after modifying it to update the label's layout.
+    */
+    void setLineBreakTable(const LineBreakTable & lineBreakTable);
+
     /**
     *  @brief
     *    Get margins for the label
@@ -273,18 +297,59 @@ public:
     */
     void setTransform3D(const glm::vec3 & origin, const glm::mat4 & transform);
 
+    /**
+    *  @brief
+    *    Get generation of the label
+    *
+    *    The generation is a globally unique number that changes whenever
+    *    a property of the label is modified. Modifications of the text
+    *    buffer itself are not included (see Text::generation()).
+    *
+    *  @return
+    *    Generation of the label
+    */
+    std::uint64_t generation() const;
+
+    /**
+    *  @brief
+    *    Get layout generation of the label
+    *
+    *    The layout generation only changes if a property is modified
+    *    that affects the layout of the glyphs in font face space, i.e.,
+    *    not if only the transformation, margins, or text color change
+    *    (see LabelLayout).
+    *
+    *  @return
+    *    Layout generation of the label
+    */
+    std::uint64_t layoutGeneration() const;
+
+
+protected:
+    /**
+    *  @brief
+    *    Assign a new generation after the label has been modified
+    *
+    *  @param[in] layout
+    *    'true' if the modification affects the layout, else 'false'
+    */
+    void updateGeneration(bool layout);
+
 
 protected:
-    std::shared_ptr<Text> m_text;      ///< Text that is rendered
-    FontFace            * m_fontFace;  ///< The used font face
-    float                 m_fontSize;  ///< Font size for rendering (in pt)
-    bool                  m_wordWrap;  ///< Wrap words at the end of a line?
-    float                 m_lineWidth; ///< Width of a line (in pt)
-    glm::vec4             m_margins;   ///< Margins (top/right/bottom/left, in pt)
-    Alignment             m_alignment; ///< Horizontal text alignment
-    LineAnchor            m_anchor;    ///< Vertical line anchor
-    glm::mat4             m_transform; ///< Transformation for the label
-    glm::vec4             m_textColor; ///< Text color (rgba)
+    std::shared_ptr<Text> m_text;             ///< Text that is rendered
+    FontFace            * m_fontFace;         ///< The used font face
+    float                 m_fontSize;         ///< Font size for rendering (in pt)
+    bool                  m_wordWrap;         ///< Wrap words at the end of a line?
+    float                 m_lineWidth;        ///< Width of a line (in pt)
+    const LineBreakTable * m_lineBreakTable;  ///< Line break classes used for word wrapping
+    glm::vec4             m_margins;          ///< Margins (top/right/bottom/left, in pt)
+    Alignment             m_alignment;        ///< Horizontal text alignment
+    LineAnchor            m_anchor;           ///< Vertical line anchor
+    glm::mat4             m_transform;        ///< Transformation for the label
+    glm::vec4             m_textColor;        ///< Text color (rgba)
+    std::uint64_t         m_generation;       ///< Globally unique number that changes on modification
+    std::uint64_t         m_layoutGeneration; ///< Generation of the last modification that affects the layout
 };
 
 
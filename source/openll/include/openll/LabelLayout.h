@@ -0,0 +1,108 @@
+
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/GlyphVertexCloud.h>
+
+
+namespace openll
+{
+
+
+class Label;
+class Text;
+
+
+/**
+*  @brief
+*    Layout of a label in font face space
+*
+*    The layout is the result of the first typesetting stage, i.e.,
+*    line breaking and alignment of the glyphs, which only depends on
+*    the text, font face, font size, and line properties of a label.
+*    Its vertices are neither transformed nor colored. The second stage
+*    (see Typesetter::typeset()) applies the transformation and text
+*    color of the label, so moving or recoloring a label does not
+*    require to recompute its layout.
+*/
+class OPENLL_API LabelLayout
+{
+    friend class Typesetter;
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *    Constructs an empty layout, which is not valid for any label.
+    */
+    LabelLayout();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~LabelLayout();
+
+    /**
+    *  @brief
+    *    Check if the layout is up to date for a label
+    *
+    *  @param[in] label
+    *    Label to check
+    *
+    *  @return
+    *    'true' if the layout has been computed for the current layout
+    *    properties of the label, its text, font face, and line break
+    *    table, else 'false'
+    *
+    *  @see Label::layoutGeneration(), Text::generation(), FontFace::generation(), LineBreakTable::generation()
+    */
+    bool isValid(const Label & label) const;
+
+    /**
+    *  @brief
+    *    Get vertices of the depictable glyphs (in font face space)
+    *
+    *  @return
+    *    Untransformed vertices without text color
+    */
+    const std::vector<GlyphVertexCloud::Vertex> & vertices() const;
+
+    /**
+    *  @brief
+    *    Get extent of each line (in font face space)
+    *
+    *  @return
+    *    Width and height of each line, from top to bottom
+    */
+    const std::vector<glm::vec2> & lineExtents() const;
+
+    /**
+    *  @brief
+    *    Get extent of the layout (in font face space)
+    *
+    *  @return
+    *    Maximum line width and the sum of all line heights
+    */
+    const glm::vec2 & extent() const;
+
+
+protected:
+    std::vector<GlyphVertexCloud::Vertex> m_vertices;         ///< Untransformed vertices of the depictable glyphs
+    std::vector<glm::vec2>                m_lineExtents;      ///< Extent of each line
+    glm::vec2                             m_extent;           ///< Extent of the layout
+    std::uint64_t                         m_layoutGeneration; ///< Layout generation of the label when it was layouted
+    const Text                          * m_text;             ///< Text of the label when it was layouted
+    std::uint64_t                         m_textGeneration;   ///< Generation of the text when it was layouted
+    std::uint64_t                         m_fontFaceGeneration;       ///< Generation of the font face when it was layouted
+    std::uint64_t                         m_lineBreakTableGeneration; ///< Generation of the line break table when it was layouted
+};
+
+
+} // namespace openll
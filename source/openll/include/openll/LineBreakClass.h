@@ -0,0 +1,24 @@
+
+#pragma once
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Line breaking behavior of a character (subset of UAX #14)
+*/
+enum class LineBreakClass : unsigned char
+{
+    Other,       ///< No break opportunity around the character (e.g., letters and digits)
+    Space,       ///< Break after the character (e.g., spaces); never at the start of a line
+    Hyphen,      ///< Break after the character (e.g., hyphens); never at the start of a line
+    BreakAfter,  ///< Break after the character (e.g., punctuation and brackets); never at the start of a line
+    Ideographic, ///< Break before and after the character (e.g., CJK ideographs and kana)
+    NoBreak      ///< Prohibit breaks before and after the character (e.g., no-break space)
+};
+
+
+} // namespace openll
@@ -0,0 +1,157 @@
+
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+
+#include <openll/LineBreakClass.h>
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Line break classes of all characters
+*
+*    The classes of the basic multilingual plane are looked up in a
+*    two-level table: the upper byte of a character selects a block of
+*    256 classes, the lower byte the class within the block. Blocks
+*    that share the same classes (e.g., the CJK ideographs) are stored
+*    only once. The default table is generated at compile time; tables
+*    are reclassified by copying it on first modification.
+*
+*    Lookups take constant time and do not synchronize, so a table can
+*    be queried concurrently as long as it is not modified.
+*/
+class OPENLL_API LineBreakTable
+{
+public:
+    /**
+    *  @brief
+    *    Get the default table
+    *
+    *  @return
+    *    Table with the default line break classes (see LineBreakClass)
+    */
+    static const LineBreakTable & defaultTable();
+
+    /**
+    *  @brief
+    *    Check if a line can be broken between two characters
+    *
+    *  @param[in] before
+    *    Class of the character before the break
+    *  @param[in] after
+    *    Class of the character after the break
+    *
+    *  @return
+    *    'true' if a line can be broken, else 'false'
+    *
+    *  @remarks
+    *    Mandatory breaks (i.e., line feeds) are handled by the typesetter.
+    */
+    static bool isBreakOpportunity(LineBreakClass before, LineBreakClass after);
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *    Creates a table with the default line break classes.
+    */
+    LineBreakTable();
+
+    /**
+    *  @brief
+    *    Copy constructor
+    *
+    *  @param[in] other
+    *    Table to copy
+    */
+    LineBreakTable(const LineBreakTable & other);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~LineBreakTable();
+
+    /**
+    *  @brief
+    *    Copy assignment
+    *
+    *  @param[in] other
+    *    Table to copy
+    *
+    *  @return
+    *    Reference to this table
+    */
+    LineBreakTable & operator=(const LineBreakTable & other);
+
+    /**
+    *  @brief
+    *    Get line break class of a character
+    *
+    *  @param[in] character
+    *    Character (32 bit unicode)
+    *
+    *  @return
+    *    Line break class of the character
+    */
+    LineBreakClass lineBreakClass(char32_t character) const;
+
+    /**
+    *  @brief
+    *    Set line break class of a character
+    *
+    *  @param[in] character
+    *    Character (32 bit unicode), has to be in the basic multilingual plane
+    *  @param[in] lineBreakClass
+    *    Line break class of the character
+    */
+    void setLineBreakClass(char32_t character, LineBreakClass lineBreakClass);
+
+    /**
+    *  @brief
+    *    Get generation of the table
+    *
+    *  @return
+    *    Globally unique number that changes on modification
+    */
+    std::uint64_t generation() const;
+
+
+public:
+    /**
+    *  @brief
+    *    Line break classes of 256 consecutive characters
+    */
+    struct Block
+    {
+        LineBreakClass classes[256]; ///< Line break class of each character of the block
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Copy the default table before its first modification
+    */
+    void detach();
+
+
+protected:
+    const std::uint16_t      * m_stage1;      ///< Block index for each upper byte of the basic multilingual plane
+    const Block              * m_blocks;      ///< Blocks of line break classes
+    std::vector<std::uint16_t> m_ownStage1;   ///< Modified block indices (empty until modified)
+    std::vector<Block>         m_ownBlocks;   ///< Modified blocks (empty until modified)
+    std::uint64_t              m_generation;  ///< Globally unique number that changes on modification
+};
+
+
+} // namespace openll
@@ -2,6 +2,10 @@
 #pragma once
 
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 
 #include <openll/openll_api.h>
@@ -11,6 +15,10 @@ namespace openll
 {
 
 
+class BreakIndex;
+class FontFace;
+class LineBreakTable;
+
 /**
 *  @brief
 *    Text buffer
@@ -20,6 +28,10 @@ namespace openll
 */
 class OPENLL_API Text
 {
+public:
+    static const std::size_t numCachedBreakIndices = 4; ///< Number of combinations of font face and line break table with a cached break index
+
+
 public:
     /**
     *  @brief
@@ -81,10 +93,55 @@ public:
     */
     void setLineFeed(char32_t linefeed);
 
+    /**
+    *  @brief
+    *    Get generation of the text
+    *
+    *    The generation is a globally unique number that changes whenever
+    *    the text or the linefeed character is modified. It can be used to
+    *    detect changes without comparing the entire text.
+    *
+    *  @return
+    *    Generation of the text
+    */
+    std::uint64_t generation() const;
+
+    /**
+    *  @brief
+    *    Get break index of the text for a font face and line break table
+    *
+    *    The break index is built on first use and cached until the text,
+    *    the line feed character, the font face, or the line break table
+    *    is modified. Break indices for up to numCachedBreakIndices
+    *    combinations of font face and line break table are cached at
+    *    once, so a text shared by labels with different font faces is not
+    *    re-indexed on each use. Concurrent calls are safe.
+    *
+    *  @param[in] fontFace
+    *    Font face providing advances and kernings
+    *  @param[in] lineBreakTable
+    *    Line break classes of the characters
+    *
+    *  @return
+    *    Break index (never null)
+    */
+    std::shared_ptr<const BreakIndex> breakIndex(const FontFace & fontFace, const LineBreakTable & lineBreakTable) const;
+
 
 protected:
-    std::u32string m_text;     ///< Text that is rendered
-    char32_t       m_linefeed; ///< Character that marks the end of a line
+    /**
+    *  @brief
+    *    Discard all cached break indices
+    */
+    void clearBreakIndices();
+
+
+protected:
+    std::u32string m_text;       ///< Text that is rendered
+    char32_t       m_linefeed;   ///< Character that marks the end of a line
+    std::uint64_t  m_generation; ///< Globally unique number that changes on modification
+
+    mutable std::array<std::shared_ptr<const BreakIndex>, numCachedBreakIndices> m_breakIndices; ///< Cached break indices (accessed atomically)
 };
 
 
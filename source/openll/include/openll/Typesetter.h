@@ -2,9 +2,11 @@
 #pragma once
 
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
-#include <map>
 
 #include <glm/fwd.hpp>
 
@@ -17,8 +19,8 @@ namespace openll
 
 enum class Alignment : unsigned char;
 class Label;
+class LabelLayout;
 class FontFace;
-class Glyph;
 
 
 /**
@@ -35,6 +37,19 @@ class Glyph;
 */
 class OPENLL_API Typesetter
 {
+    friend class IncrementalTypesetter;
+
+public:
+    /**
+    *  @brief
+    *    Receiver of typeset vertices (see typeset(const VertexSink &, const Label &))
+    *
+    *    The vertices are transformed and colored. They are only valid
+    *    during the call and are overwritten afterwards.
+    */
+    using VertexSink = std::function<void(const GlyphVertexCloud::Vertex * vertices, std::size_t count)>;
+
+
 public:
     Typesetter() = delete;
     ~Typesetter() = delete;
@@ -50,15 +65,39 @@ public:
     *    Extent of the label (in output space)
     *
     *  @remarks
-    *    This function internally performs the typesetting of the
-    *    text, but only returns its extent, disregarding the resulting
-    *    vertex array.
+    *    This function walks the advances, kernings, and line breaks of
+    *    the text without creating any vertices. The result equals the
+    *    extent returned by typesetting the label. Glyph metrics and
+    *    kernings are cached per thread until the font face is modified
+    *    (see FontFace::generation()).
     *
     *  @notes
     *    - Before calling this function, a valid font face has to be set on the label.
     */
     static glm::vec2 extent(const Label & label);
 
+    /**
+    *  @brief
+    *    Get the extents of multiple labels
+    *
+    *  @param[in] labels
+    *    Labels to measure
+    *  @param[in] parallel
+    *    Measure labels concurrently on multiple threads?
+    *
+    *  @return
+    *    Extent of each label (in output space), zero for labels without font face or text (or null labels)
+    *
+    *  @remarks
+    *    The results equal those of calling extent() for each label.
+    *    In parallel mode, the labels are split into chunks of roughly
+    *    equal text length that are measured on separate threads. Each
+    *    thread is started per call and fills its own glyph cache, so
+    *    only texts of at least 16k characters per thread are measured
+    *    concurrently, and shorter lists are measured on the calling thread.
+    */
+    static std::vector<glm::vec2> extents(const std::vector<const Label *> & labels, bool parallel = false);
+
     /**
     *  @brief
     *    Typeset (layout) the given text
@@ -68,7 +107,7 @@ public:
     *  @param[in] label
     *    Label to display
     *  @param[in] optimize
-    *    Optimize vertex cloud for rendering performance? (slow for large texts!)
+    *    Optimize vertex cloud for rendering performance?
     *  @param[in] dryrun
     *    Do not create output, just compute the extent?
     *
@@ -76,16 +115,89 @@ public:
     *    Extent of the label (in output space)
     *
     *  @remarks
-    *    Keep in mind that optimizing the vertex array is a slow process
-    *    itself and also needs a lot of memory, as the vertex array has
-    *    to be sorted. Therefore, optimization might not be advisable for
-    *    large texts.
+    *    Keep in mind that optimizing the vertex array needs additional
+    *    memory, as the vertex array has to be sorted. The sorting scratch
+    *    storage is kept per thread and reused by subsequent calls.
+    *
+    *    A streaming vertex cloud (see GlyphVertexCloud::isStreaming()) is
+    *    typeset into per-thread scratch storage and copied into its next
+    *    segment at once. A label that exceeds the capacity of the segment
+    *    (see GlyphVertexCloud::streamCapacity()) is not drawn and yields
+    *    a zero extent, and an assertion is thrown.
     *
     *  @notes
     *    - Before calling this function, a valid font face has to be set on the label.
     */
     static glm::vec2 typeset(GlyphVertexCloud & vertexCloud, const Label & label, bool optimize = false, bool dryrun = false);
 
+    /**
+    *  @brief
+    *    Get the number of vertices the label is typeset into
+    *
+    *  @param[in] label
+    *    Label to display
+    *
+    *  @return
+    *    Number of depictable glyphs of the text, 0 for labels without font face or text
+    *
+    *  @remarks
+    *    This is the capacity required by typeset(GlyphVertexCloud::Vertex *, std::size_t, const Label &, std::size_t *).
+    *    It does not depend on word wrap, as line breaking never drops glyphs.
+    */
+    static std::size_t vertexCount(const Label & label);
+
+    /**
+    *  @brief
+    *    Typeset (layout) the given text into a caller-provided buffer
+    *
+    *    The vertices are written directly into the buffer, e.g., a
+    *    mapped GPU buffer or an arena, without intermediate copies.
+    *
+    *  @param[out] vertices
+    *    Buffer the vertices are written to
+    *  @param[in] capacity
+    *    Number of vertices the buffer can hold (at least vertexCount())
+    *  @param[in] label
+    *    Label to display
+    *  @param[out] count
+    *    Number of vertices written (can be nullptr)
+    *  @param[in] optimize
+    *    Optimize vertices for rendering performance?
+    *
+    *  @return
+    *    Extent of the label (in output space), zero if the capacity is insufficient
+    *
+    *  @remarks
+    *    Optimizing sorts the vertices in per-thread scratch storage and
+    *    copies them back into the buffer.
+    *
+    *  @notes
+    *    - A capacity of the text length is always sufficient and skips counting the vertices.
+    */
+    static glm::vec2 typeset(GlyphVertexCloud::Vertex * vertices, std::size_t capacity, const Label & label, std::size_t * count = nullptr, bool optimize = false);
+
+    /**
+    *  @brief
+    *    Typeset (layout) the given text into a sink
+    *
+    *    The sink is called once for each line that contains depictable
+    *    glyphs, from top to bottom, as soon as the line is complete. The
+    *    vertices are passed in per-thread scratch storage, which is reused
+    *    by subsequent calls, so no allocations occur after warm-up.
+    *
+    *  @param[in] sink
+    *    Receiver of the vertices of each line
+    *  @param[in] label
+    *    Label to display
+    *
+    *  @return
+    *    Extent of the label (in output space)
+    *
+    *  @notes
+    *    - The sink must not typeset on the same thread, as it would overwrite the scratch storage.
+    */
+    static glm::vec2 typeset(const VertexSink & sink, const Label & label);
+
     /**
     *  @brief
     *    Typeset (layout) the given text
@@ -95,20 +207,36 @@ public:
     *  @param[in] labels
     *    List of labels to display
     *  @param[in] optimize
-    *    Optimize vertex cloud for rendering performance? (slow for large texts!)
+    *    Optimize vertex cloud for rendering performance?
     *  @param[in] dryrun
     *    Do not create output, just compute the extent?
     *  @param[out] positions
     *    The indices of the labels in the resulting attributed vertex cloud
+    *  @param[in] parallel
+    *    Typeset the labels concurrently on all available hardware threads?
     *
     *  @return
     *    Extent of the label (in output space)
     *
     *  @remarks
-    *    Keep in mind that optimizing the vertex array is a slow process
-    *    itself and also needs a lot of memory, as the vertex array has
-    *    to be sorted. Therefore, optimization might not be advisable for
-    *    large texts.
+    *    Keep in mind that optimizing the vertex array needs additional
+    *    memory, as the vertex array has to be sorted. The sorting scratch
+    *    storage is kept per thread and reused by subsequent calls.
+    *
+    *    A streaming vertex cloud (see GlyphVertexCloud::isStreaming()) is
+    *    typeset into per-thread scratch storage and copied into its next
+    *    segment at once. Vertices are then sorted per label only. Labels
+    *    that exceed the remaining capacity of the segment (see
+    *    GlyphVertexCloud::streamCapacity()) are dropped: they are not
+    *    drawn, do not contribute to the extent, and get an empty range in
+    *    positions, so positions stays aligned with the labels. Dropping a
+    *    label throws an assertion. Use vertexCount() to check the capacity
+    *    in advance.
+    *
+    *    The parallel mode produces vertices, positions, and extent that are
+    *    bit-identical to the serial mode. It pays off for many labels or
+    *    large texts only, as it comes with the overhead of spawning threads
+    *    and an additional copy of the resulting vertices.
     *
     *  @notes
     *    - Before calling this function, a valid font face has to be set on the label.
@@ -117,7 +245,36 @@ public:
     *      is not met, the vertex cloud will use the first font face found, and an
     *      assertion will be thrown.
     */
-    static glm::vec2 typeset(GlyphVertexCloud & vertexCloud, const std::vector<Label> & labels, bool optimize = false, bool dryrun = false, std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions = nullptr);
+    static glm::vec2 typeset(GlyphVertexCloud & vertexCloud, const std::vector<Label> & labels, bool optimize = false, bool dryrun = false, std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions = nullptr, bool parallel = false);
+
+    /**
+    *  @brief
+    *    Typeset (layout) the given text into a vertex list in CPU memory
+    *
+    *    Behaves like typeset(GlyphVertexCloud &, const std::vector<Label> &, bool, bool, std::vector<std::pair<std::uint32_t, std::uint32_t>> *, bool),
+    *    but neither uploads the vertices nor requires an OpenGL context.
+    *
+    *  @param[out] vertices
+    *    Vertex list that is constructed (previous contents are discarded)
+    *  @param[in] labels
+    *    List of labels to display
+    *  @param[in] optimize
+    *    Optimize vertex list for rendering performance?
+    *  @param[in] dryrun
+    *    Do not create output, just compute the extent?
+    *  @param[out] positions
+    *    The indices of the labels in the resulting vertex list
+    *  @param[in] parallel
+    *    Typeset the labels concurrently on all available hardware threads?
+    *
+    *  @return
+    *    Extent of the label (in output space)
+    *
+    *  @remarks
+    *    The parallel mode relies on const FontFace being safe to share
+    *    across threads (see FontFace).
+    */
+    static glm::vec2 typeset(std::vector<GlyphVertexCloud::Vertex> & vertices, const std::vector<Label> & labels, bool optimize = false, bool dryrun = false, std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions = nullptr, bool parallel = false);
 
     /**
     *  @brief
@@ -128,7 +285,7 @@ public:
     *  @param[in] labels
     *    List of labels to display
     *  @param[in] optimize
-    *    Optimize vertex cloud for rendering performance? (slow for large texts!)
+    *    Optimize vertex cloud for rendering performance?
     *  @param[in] dryrun
     *    Do not create output, just compute the extent?
     *
@@ -136,10 +293,17 @@ public:
     *    Extent of the label (in output space)
     *
     *  @remarks
-    *    Keep in mind that optimizing the vertex array is a slow process
-    *    itself and also needs a lot of memory, as the vertex array has
-    *    to be sorted. Therefore, optimization might not be advisable for
-    *    large texts.
+    *    Keep in mind that optimizing the vertex array needs additional
+    *    memory, as the vertex array has to be sorted. The sorting scratch
+    *    storage is kept per thread and reused by subsequent calls.
+    *
+    *    A streaming vertex cloud (see GlyphVertexCloud::isStreaming()) is
+    *    typeset into per-thread scratch storage and copied into its next
+    *    segment at once. Vertices are then sorted per label only. Labels
+    *    that exceed the remaining capacity of the segment (see
+    *    GlyphVertexCloud::streamCapacity()) are dropped: they are not
+    *    drawn and do not contribute to the extent. Dropping a label throws
+    *    an assertion. Use vertexCount() to check the capacity in advance.
     *
     *  @notes
     *    - Before calling this function, a valid font face has to be set on the label.
@@ -150,20 +314,114 @@ public:
     */
     static glm::vec2 typeset(GlyphVertexCloud & vertexCloud, const std::vector<const Label *> & labels, bool optimize = false, bool dryrun = false);
 
+    /**
+    *  @brief
+    *    Layout the given text in font face space
+    *
+    *    This performs the first stage of typesetting, i.e., line breaking
+    *    and alignment, but does not apply the transformation and text
+    *    color of the label. The layout remains valid until a property
+    *    of the label that affects the layout or its text is changed
+    *    (see LabelLayout::isValid()).
+    *
+    *  @param[out] layout
+    *    Layout that is constructed
+    *  @param[in] label
+    *    Label to layout
+    */
+    static void layout(LabelLayout & layout, const Label & label);
+
+    /**
+    *  @brief
+    *    Typeset (transform) a previously computed layout
+    *
+    *    This performs the second stage of typesetting, i.e., it applies
+    *    the transformation and text color of the label to the layout.
+    *    Use this to move or recolor a label without re-layouting its text.
+    *
+    *  @param[in,out] vertexCloud
+    *    Vertex cloud that is constructed
+    *  @param[in] layout
+    *    Layout of the label (must be valid for the label, see LabelLayout::isValid())
+    *  @param[in] label
+    *    Label to display
+    *
+    *  @return
+    *    Extent of the label (in output space)
+    */
+    static glm::vec2 typeset(GlyphVertexCloud & vertexCloud, const LabelLayout & layout, const Label & label);
+
+    /**
+    *  @brief
+    *    Typeset (transform) a previously computed layout into a caller-provided buffer
+    *
+    *  @param[out] vertices
+    *    Buffer the vertices are written to
+    *  @param[in] capacity
+    *    Number of vertices the buffer can hold (at least the number of vertices of the layout)
+    *  @param[in] layout
+    *    Layout of the label (must be valid for the label, see LabelLayout::isValid())
+    *  @param[in] label
+    *    Label to display
+    *
+    *  @return
+    *    Extent of the label (in output space), zero if the capacity is insufficient
+    */
+    static glm::vec2 typeset(GlyphVertexCloud::Vertex * vertices, std::size_t capacity, const LabelLayout & layout, const Label & label);
+
 
 private:
+    /**
+    *  @brief
+    *    Handler of the vertices of a completed line (see layout_label())
+    */
+    using LineHandler = std::function<void(GlyphVertexCloud::Vertex * vertices, std::size_t count)>;
+
+    /**
+    *  @brief
+    *    Typeset labels concurrently
+    *
+    *    The labels are partitioned into contiguous chunks of similar text
+    *    length, which are typeset into separate vertex ranges by one thread
+    *    each. A prefix sum over the per-label glyph counts then places the
+    *    ranges into the resulting vertex array in label order.
+    *
+    *  @param[in,out] vertices
+    *    Vertex array
+    *  @param[in,out] glyphIndices
+    *    Glyph index of each vertex for sorting the vertices (only used for optimize)
+    *  @param[in] labels
+    *    List of labels to layout
+    *  @param[in] optimize
+    *    Optimize vertex cloud for rendering performance?
+    *  @param[in] dryrun
+    *    Do not create output, just compute the extent?
+    *  @param[out] positions
+    *    The indices of the labels in the resulting attributed vertex cloud
+    *
+    *  @return
+    *    Extent of the labels (in output space)
+    */
+    static glm::vec2 typeset_parallel(
+        std::vector<GlyphVertexCloud::Vertex> & vertices
+    ,   std::vector<std::uint32_t> & glyphIndices
+    ,   const std::vector<Label> & labels
+    ,   bool optimize
+    ,   bool dryrun
+    ,   std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions);
+
     /**
     *  @brief
     *    Typeset label
     *
     *  @param[in,out] vertices
     *    Vertex array
-    *  @param[in,out] buckets
-    *    Buckets for sorting the vertices (only used for optimize)
+    *  @param[in,out] glyphIndices
+    *    Glyph index of each vertex for sorting the vertices (only used for optimize)
     *  @param[in] label
     *    Label to layout
     *  @param[in] optimize
-    *    Optimize vertex cloud for rendering performance? (slow for large texts!)
+    *    Optimize vertex cloud for rendering performance?
     *  @param[in] dryrun
     *    Do not create output, just compute the extent?
     *
@@ -172,35 +430,60 @@ private:
     */
     static glm::vec2 typeset_label(
         std::vector<GlyphVertexCloud::Vertex> & vertices
-    ,   std::map<size_t, std::vector<size_t>> & buckets
+    ,   std::vector<std::uint32_t> & glyphIndices
     ,   const Label & label
     ,   bool optimize = false
     ,   bool dryrun = false);
 
     /**
     *  @brief
-    *    Determine whether the next word needs to be wrapped
+    *    Measure label in font face space
+    *
+    *    Computes the same extent as layout_label() in dry run mode,
+    *    using the glyph metrics cache of the current thread. With word
+    *    wrap, only the line ends are looked up in the break index.
     *
     *  @param[in] label
+    *    Label to measure (font face and text must be set)
+    *
+    *  @return
+    *    Extent of the label (in font face space)
+    */
+    static glm::vec2 measure_label(const Label & label);
+
+    /**
+    *  @brief
+    *    Layout label in font face space
+    *
+    *  @param[out] vertices
+    *    Vertex buffer (capacity of at least vertexCount(), can be nullptr for dryrun)
+    *  @param[in,out] count
+    *    Number of vertices in the buffer
+    *  @param[in,out] glyphIndices
+    *    Glyph index of each vertex for sorting the vertices (only used for optimize)
+    *  @param[in] label
     *    Label to layout
-    *  @param[in] lineWidth
-    *    The maximum line width
-    *  @param[in] pen
-    *    Current typesetting position
-    *  @param[in] glyph
-    *    Glyph that is rendered
-    *  @param[in] kerning
-    *    Kerning space to previous character
+    *  @param[in] optimize
+    *    Optimize vertex cloud for rendering performance?
+    *  @param[in] dryrun
+    *    Do not create output, just compute the extent?
+    *  @param[out] lineExtents
+    *    Extent of each line (can be nullptr)
+    *  @param[in] onLine
+    *    Handler of the vertices of each line, which are discarded afterwards (can be nullptr)
     *
     *  @return
-    *    'true' if word need to be wrapped, else 'false'
+    *    Extent of the label (in font face space)
     */
-    static bool typeset_wordwrap(
-        const Label & label
-    ,   float lineWidth
-    ,   const glm::vec2 & pen
-    ,   const Glyph & glyph
-    ,   float kerning);
+    static glm::vec2 layout_label(
+        GlyphVertexCloud::Vertex * vertices
+    ,   std::size_t & count
+    ,   std::vector<std::uint32_t> & glyphIndices
+    ,   const Label & label
+    ,   bool optimize
+    ,   bool dryrun
+    ,   std::vector<glm::vec2> * lineExtents
+    ,   const LineHandler * onLine = nullptr);
 
     /**
     *  @brief
@@ -211,25 +494,29 @@ private:
     *
     *  @param[in,out] vertices
     *    Vertex array
-    *  @param[in,out] buckets
-    *    Buckets for sorting the vertices (only used for optimize)
+    *  @param[in,out] glyphIndices
+    *    Glyph index of each vertex for sorting the vertices (only used for optimize)
     *  @param[in] index
     *    Index of the current vertex
-    *  @param[in] fontFace
-    *    The used font face
     *  @param[in] pen
     *    Current typesetting position
-    *  @param[in] glyph
-    *    Glyph that is rendered
+    *  @param[in] penRectangle
+    *    Pen origin and tangent/bitangent lengths of the glyph (see GlyphMetricsTable)
+    *  @param[in] subtextureRectangle
+    *    Sub-texture rectangle of the glyph
+    *  @param[in] glyphIndex
+    *    Index of the glyph
     *  @param[in] optimize
-    *    Optimize vertex cloud for rendering performance? (slow for large texts!)
+    *    Optimize vertex cloud for rendering performance?
     */
     static void typeset_glyph(
-        std::vector<GlyphVertexCloud::Vertex> & vertices
-    ,   std::map<size_t, std::vector<size_t>> & buckets
+        GlyphVertexCloud::Vertex * vertices
+    ,   std::vector<std::uint32_t> & glyphIndices
     ,   size_t index
     ,   const glm::vec2 & pen
-    ,   const Glyph & glyph
+    ,   const glm::vec4 & penRectangle
+    ,   const glm::vec4 & subtextureRectangle
+    ,   std::uint32_t glyphIndex
     ,   bool optimize);
 
     /**
@@ -250,7 +537,7 @@ private:
     static void typeset_align(
         const glm::vec2 & pen
     ,   const Alignment alignment
-    ,   std::vector<GlyphVertexCloud::Vertex> & vertices
+    ,   GlyphVertexCloud::Vertex * vertices
     ,   size_t begin
     ,   size_t end);
 
@@ -259,6 +546,9 @@ private:
     *    Calculate transformed positions for the current glyphs
     *
     *    This configures the final vertex information for each glyph.
+    *    Batches of glyphs are transformed using SIMD instructions, if
+    *    available. Tangent and bitangent are transformed by the linear
+    *    part of the transformation only.
     *
     *  @param[in] label
     *    Label to layout
@@ -274,7 +564,7 @@ private:
     static void vertex_transform(
         const glm::mat4 & label
     ,   const glm::vec4 & textColor
-    ,   std::vector<GlyphVertexCloud::Vertex> & vertices
+    ,   GlyphVertexCloud::Vertex * vertices
     ,   size_t begin
     ,   size_t end);
 
@@ -298,14 +588,38 @@ private:
     *  @brief
     *    Apply vertex array optimization
     *
+    *    The vertices are stably sorted by glyph index using a radix sort
+    *    on reusable, per-thread scratch storage. Radix passes in which all
+    *    glyph indices share the same digit are skipped, so typical texts
+    *    are sorted by a single counting sort pass.
+    *
     *  @param[in,out] vertices
     *    Vertex array
-    *  @param[in] buckets
-    *    Buckets for sorting the vertices
+    *  @param[in,out] glyphIndices
+    *    Glyph index of each vertex (is sorted along with the vertices)
     */
     static void optimize_vertices(
         std::vector<GlyphVertexCloud::Vertex> & vertices
-    ,   const std::map<size_t, std::vector<size_t>> & buckets);
+    ,   std::vector<std::uint32_t> & glyphIndices);
+
+    /**
+    *  @brief
+    *    Apply vertex array optimization to a caller-provided buffer
+    *
+    *    Sorts like the other overload, but copies the vertices back into
+    *    the buffer if the sorted vertices end up in the scratch storage.
+    *
+    *  @param[in,out] vertices
+    *    Vertex buffer
+    *  @param[in] size
+    *    Number of vertices
+    *  @param[in,out] glyphIndices
+    *    Glyph index of each vertex (is sorted along with the vertices)
+    */
+    static void optimize_vertices(
+        GlyphVertexCloud::Vertex * vertices
+    ,   std::size_t size
+    ,   std::vector<std::uint32_t> & glyphIndices);
 };
 
 
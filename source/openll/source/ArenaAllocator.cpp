@@ -0,0 +1,126 @@
+
+#include "ArenaAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+
+namespace openll
+{
+
+
+const std::size_t ArenaAllocator::invalidOffset = std::numeric_limits<std::size_t>::max();
+
+
+ArenaAllocator::ArenaAllocator(const std::size_t capacity)
+: m_capacity(capacity)
+, m_available(capacity)
+{
+    if (capacity > 0)
+    {
+        m_freeBlocks.emplace(0, capacity);
+    }
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+}
+
+std::size_t ArenaAllocator::allocate(const std::size_t size)
+{
+    assert(size > 0);
+
+    for (auto it = m_freeBlocks.begin(); it != m_freeBlocks.end(); ++it)
+    {
+        if (it->second < size)
+        {
+            continue;
+        }
+
+        const auto offset = it->first;
+        const auto remaining = it->second - size;
+
+        // Keep the remainder of the block free
+        m_freeBlocks.erase(it);
+
+        if (remaining > 0)
+        {
+            m_freeBlocks.emplace(offset + size, remaining);
+        }
+
+        m_available -= size;
+
+        return offset;
+    }
+
+    return invalidOffset;
+}
+
+void ArenaAllocator::free(std::size_t offset, std::size_t size)
+{
+    assert(size > 0);
+    assert(offset + size <= m_capacity);
+
+    m_available += size;
+
+    // Merge with the following free block
+    const auto next = m_freeBlocks.find(offset + size);
+
+    if (next != m_freeBlocks.end())
+    {
+        size += next->second;
+        m_freeBlocks.erase(next);
+    }
+
+    // Merge with the preceding free block
+    auto it = m_freeBlocks.lower_bound(offset);
+
+    assert(it == m_freeBlocks.end() || it->first > offset);
+
+    if (it != m_freeBlocks.begin())
+    {
+        --it;
+
+        assert(it->first + it->second <= offset);
+
+        if (it->first + it->second == offset)
+        {
+            it->second += size;
+
+            return;
+        }
+    }
+
+    m_freeBlocks.emplace(offset, size);
+}
+
+std::size_t ArenaAllocator::capacity() const
+{
+    return m_capacity;
+}
+
+std::size_t ArenaAllocator::available() const
+{
+    return m_available;
+}
+
+std::size_t ArenaAllocator::largestFreeBlock() const
+{
+    auto largest = std::size_t(0);
+
+    for (const auto & block : m_freeBlocks)
+    {
+        largest = std::max(largest, block.second);
+    }
+
+    return largest;
+}
+
+std::size_t ArenaAllocator::numFreeBlocks() const
+{
+    return m_freeBlocks.size();
+}
+
+
+} // namespace openll
@@ -0,0 +1,117 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <map>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Allocator of ranges within a fixed-size arena
+*
+*    Keeps a free list ordered by offset. Allocation takes the first free
+*    block that is large enough (first fit), freeing merges the block with
+*    adjacent free blocks, so the arena does not fragment into ranges
+*    smaller than what has been freed.
+*
+*    Only manages offsets, so it can be used for any kind of storage. Used
+*    by GlyphVertexArena to sub-allocate vertex ranges of shared buffers.
+*    Requires no OpenGL context.
+*/
+class OPENLL_API ArenaAllocator
+{
+public:
+    static const std::size_t invalidOffset; ///< Offset returned if an allocation fails
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] capacity
+    *    Size of the arena
+    */
+    explicit ArenaAllocator(std::size_t capacity);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~ArenaAllocator();
+
+    /**
+    *  @brief
+    *    Allocate a range
+    *
+    *  @param[in] size
+    *    Size of the range (has to be greater than 0)
+    *
+    *  @return
+    *    Offset of the range, invalidOffset if no free block is large enough
+    */
+    std::size_t allocate(std::size_t size);
+
+    /**
+    *  @brief
+    *    Free a range
+    *
+    *  @param[in] offset
+    *    Offset of the range (as returned by allocate())
+    *  @param[in] size
+    *    Size of the range (as passed to allocate())
+    */
+    void free(std::size_t offset, std::size_t size);
+
+    /**
+    *  @brief
+    *    Get size of the arena
+    *
+    *  @return
+    *    Size of the arena
+    */
+    std::size_t capacity() const;
+
+    /**
+    *  @brief
+    *    Get size of all free blocks
+    *
+    *  @return
+    *    Free size
+    */
+    std::size_t available() const;
+
+    /**
+    *  @brief
+    *    Get size of the largest free block
+    *
+    *  @return
+    *    Largest size that can be allocated
+    */
+    std::size_t largestFreeBlock() const;
+
+    /**
+    *  @brief
+    *    Get number of free blocks
+    *
+    *  @return
+    *    Number of free blocks (1 for an empty arena)
+    */
+    std::size_t numFreeBlocks() const;
+
+
+protected:
+    std::size_t                        m_capacity;   ///< Size of the arena
+    std::size_t                        m_available;  ///< Size of all free blocks
+    std::map<std::size_t, std::size_t> m_freeBlocks; ///< Size of each free block by offset
+};
+
+
+} // namespace openll
@@ -0,0 +1,102 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Layout of binary font files (.llf)
+*
+*    A binary font file starts with the header, followed by sections
+*    for the glyph records, the kerning table, and the glyph atlas
+*    pixels. Each section starts at an offset aligned to sectionAlignment,
+*    so all records can be read in place from a memory-mapped file.
+*    Glyph records are stored in order of their dense glyph id (starting
+*    at 1), the kerning table uses the layout of FontFace.
+*
+*    Values are stored in the byte order of the writing machine, which
+*    is identified by byteOrderMark. The version is incremented on any
+*    change of the layout.
+*/
+namespace BinaryFont
+{
+
+
+const char          magic[8]         = { 'O', 'P', 'E', 'N', 'L', 'L', 'F', '\0' };
+const std::uint32_t version          = 1;
+const std::uint32_t byteOrderMark    = 0x01020304;
+const std::size_t   sectionAlignment = 16;
+
+
+/**
+*  @brief
+*    File header
+*/
+struct Header
+{
+    char          magic[8];                 ///< File identifier (see BinaryFont::magic)
+    std::uint32_t version;                  ///< Layout version (see BinaryFont::version)
+    std::uint32_t byteOrderMark;            ///< Byte order check (see BinaryFont::byteOrderMark)
+
+    float         ascent;                   ///< Ascent in pt
+    float         descent;                  ///< Descent in pt
+    float         linegap;                  ///< Linegap in pt
+    std::uint32_t glyphTextureExtent[2];    ///< Size of the glyph texture in px
+    float         glyphTexturePadding[4];   ///< Padding applied to every glyph in px (top, right, bottom, left)
+
+    std::uint32_t glyphCount;               ///< Number of glyph records (without the empty glyph)
+    std::uint32_t kerningCount;             ///< Number of kerning pairs
+    std::uint32_t atlasFormat;              ///< Pixel format of the atlas (see GlyphAtlas::Format)
+    std::uint32_t atlasExtent[2];           ///< Size of the atlas in px (0 if there is no atlas)
+    std::uint32_t reserved[2];              ///< Reserved, 0
+
+    std::uint64_t glyphsOffset;             ///< File offset of the glyph records
+    std::uint64_t kerningOffsetsOffset;     ///< File offset of the kerning run offsets (glyphCount + 2 values)
+    std::uint64_t kerningIndicesOffset;     ///< File offset of the subsequent glyph indices of all kernings
+    std::uint64_t kerningAmountsOffset;     ///< File offset of the kerning amounts in 1/64 pt
+    std::uint64_t atlasOffset;              ///< File offset of the atlas pixels
+    std::uint64_t atlasSize;                ///< Size of the atlas pixels in bytes
+};
+
+/**
+*  @brief
+*    Glyph record
+*/
+struct Glyph
+{
+    std::uint32_t index;                    ///< Glyph index
+    float         advance;                  ///< Horizontal advance in pt
+    float         subTextureOrigin[2];      ///< Lower left position of the sub-texture (normalized)
+    float         subTextureExtent[2];      ///< Width and height of the sub-texture (normalized)
+    float         bearing[2];               ///< Offsets w.r.t. the pen position on the baseline
+    float         extent[2];                ///< Width and height in pt
+};
+
+
+/**
+*  @brief
+*    Round a file offset up to the section alignment
+*
+*  @param[in] offset
+*    File offset
+*
+*  @return
+*    Aligned file offset
+*/
+inline std::uint64_t align(const std::uint64_t offset)
+{
+    return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+}
+
+
+} // namespace BinaryFont
+
+
+} // namespace openll
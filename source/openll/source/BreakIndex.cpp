@@ -0,0 +1,155 @@
+
+#include <openll/BreakIndex.h>
+
+#include <cassert>
+#include <algorithm>
+
+#include <openll/FontFace.h>
+#include <openll/GlyphMetricsTable.h>
+#include <openll/LineBreakTable.h>
+
+
+
+namespace openll
+{
+
+
+BreakIndex::BreakIndex(const std::u32string & text, const char32_t lineFeed, const FontFace & fontFace, const LineBreakTable & lineBreakTable)
+: m_fontFace(&fontFace)
+, m_fontFaceGeneration(fontFace.generation())
+, m_lineBreakTable(&lineBreakTable)
+, m_lineBreakTableGeneration(lineBreakTable.generation())
+{
+    const auto size = text.size();
+
+    m_pens.resize(size);
+    m_ends.resize(size);
+    m_lastDepictable.resize(size);
+
+    // Accumulate in double precision, so differences of pen positions remain exact for large texts
+    auto pen = 0.0;
+    auto lastDepictable = std::uint32_t(0);
+    auto previousClass = LineBreakClass::Other;
+    const auto kerned = fontFace.hasKerning();
+
+    const auto & metrics = fontFace.glyphMetrics();
+    const auto advances = metrics.advances().data();
+    const auto depictables = metrics.depictables().data();
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto character = text[i];
+        const auto id = fontFace.glyphId(character);
+        const auto lineBreakClass = lineBreakTable.lineBreakClass(character);
+
+        if (i > 0 && kerned)
+        {
+            pen += fontFace.kerning(text[i - 1], character);
+        }
+
+        m_pens[i] = pen;
+        pen += advances[id];
+        m_ends[i] = pen;
+
+        if (depictables[id])
+        {
+            lastDepictable = std::uint32_t(i + 1);
+        }
+
+        m_lastDepictable[i] = lastDepictable;
+
+        // Breaks behind line feeds are mandatory
+        if (i > 0 && text[i - 1] != lineFeed && LineBreakTable::isBreakOpportunity(previousClass, lineBreakClass))
+        {
+            m_breaks.push_back(std::uint32_t(i));
+        }
+
+        if (character == lineFeed)
+        {
+            m_lineFeeds.push_back(std::uint32_t(i + 1));
+            m_breaks.push_back(std::uint32_t(i + 1));
+        }
+
+        previousClass = lineBreakClass;
+    }
+}
+
+BreakIndex::~BreakIndex()
+{
+}
+
+bool BreakIndex::isValid(const FontFace & fontFace, const LineBreakTable & lineBreakTable) const
+{
+    return isBuiltFor(fontFace, lineBreakTable)
+        && m_fontFaceGeneration == fontFace.generation() && m_lineBreakTableGeneration == lineBreakTable.generation();
+}
+
+bool BreakIndex::isBuiltFor(const FontFace & fontFace, const LineBreakTable & lineBreakTable) const
+{
+    return m_fontFace == &fontFace && m_lineBreakTable == &lineBreakTable;
+}
+
+std::size_t BreakIndex::size() const
+{
+    return m_pens.size();
+}
+
+double BreakIndex::pen(const std::size_t index) const
+{
+    return m_pens[index];
+}
+
+double BreakIndex::width(const std::size_t begin, const std::size_t end) const
+{
+    if (end <= begin || m_lastDepictable[end - 1] <= begin)
+    {
+        return 0.0;
+    }
+
+    return m_ends[m_lastDepictable[end - 1] - 1] - m_pens[begin];
+}
+
+std::size_t BreakIndex::lineEnd(const std::size_t begin, const double lineWidth) const
+{
+    assert(begin < size());
+
+    const auto fits = [this, begin, lineWidth](const std::size_t end)
+    {
+        return width(begin, end) <= lineWidth;
+    };
+
+    // The line ends at the next line feed at the latest
+    const auto lineFeed = std::upper_bound(m_lineFeeds.cbegin(), m_lineFeeds.cend(), std::uint32_t(begin));
+    const auto limit = lineFeed != m_lineFeeds.cend() ? std::size_t(*lineFeed) : size();
+
+    if (fits(limit))
+    {
+        return limit;
+    }
+
+    // Find last break opportunity at which the line fits (the width increases monotonically)
+    const auto first = std::upper_bound(m_breaks.cbegin(), m_breaks.cend(), std::uint32_t(begin));
+    const auto last = std::lower_bound(first, m_breaks.cend(), std::uint32_t(limit));
+    const auto fitting = std::partition_point(first, last, fits);
+
+    if (fitting != first)
+    {
+        return *(fitting - 1);
+    }
+
+    // Break the first word behind the last glyph that fits
+    auto lower = begin;
+    auto upper = limit;
+
+    while (upper - lower > 1)
+    {
+        const auto middle = lower + (upper - lower) / 2;
+        (fits(middle) ? lower : upper) = middle;
+    }
+
+    // Keep at least one depictable glyph on the line
+    return lower > begin && m_lastDepictable[lower - 1] > begin ? lower : upper;
+}
+
+
+} // namespace openll
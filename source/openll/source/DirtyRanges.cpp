@@ -0,0 +1,89 @@
+
+#include "DirtyRanges.h"
+
+#include <algorithm>
+
+
+namespace openll
+{
+
+
+DirtyRanges::DirtyRanges(const std::size_t mergeDistance)
+: m_mergeDistance(mergeDistance)
+, m_merged(true)
+{
+}
+
+DirtyRanges::~DirtyRanges()
+{
+}
+
+void DirtyRanges::add(const std::size_t begin, const std::size_t end)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    m_ranges.emplace_back(begin, end);
+    m_merged = m_ranges.size() == 1;
+}
+
+void DirtyRanges::clear()
+{
+    m_ranges.clear();
+    m_merged = true;
+}
+
+bool DirtyRanges::empty() const
+{
+    return m_ranges.empty();
+}
+
+const std::vector<std::pair<std::size_t, std::size_t>> & DirtyRanges::ranges() const
+{
+    if (!m_merged)
+    {
+        merge();
+    }
+
+    return m_ranges;
+}
+
+std::size_t DirtyRanges::size() const
+{
+    auto size = std::size_t(0);
+
+    for (const auto & range : ranges())
+    {
+        size += range.second - range.first;
+    }
+
+    return size;
+}
+
+void DirtyRanges::merge() const
+{
+    std::sort(m_ranges.begin(), m_ranges.end());
+
+    // Extend the last merged range by each range that starts within the merge distance
+    auto last = m_ranges.begin();
+
+    for (auto it = m_ranges.begin() + 1; it != m_ranges.end(); ++it)
+    {
+        if (it->first <= last->second + m_mergeDistance)
+        {
+            last->second = std::max(last->second, it->second);
+        }
+        else
+        {
+            *(++last) = *it;
+        }
+    }
+
+    m_ranges.erase(last + 1, m_ranges.end());
+    m_merged = true;
+}
+
+
+} // namespace openll
@@ -0,0 +1,106 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Set of index ranges that have been modified since the last upload
+*
+*    Ranges are collected in any order and merged on access: overlapping
+*    and adjacent ranges, as well as ranges separated by no more than the
+*    merge distance, are combined. Merging across small gaps trades a few
+*    redundantly uploaded elements for fewer upload calls.
+*
+*    Used by GlyphVertexCloud to upload only modified vertices. Requires
+*    no OpenGL context.
+*/
+class OPENLL_API DirtyRanges
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] mergeDistance
+    *    Maximum number of clean elements between two ranges that are merged
+    */
+    explicit DirtyRanges(std::size_t mergeDistance = 0);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~DirtyRanges();
+
+    /**
+    *  @brief
+    *    Mark a range as modified
+    *
+    *  @param[in] begin
+    *    Index of the first modified element
+    *  @param[in] end
+    *    Index behind the last modified element (empty ranges are ignored)
+    */
+    void add(std::size_t begin, std::size_t end);
+
+    /**
+    *  @brief
+    *    Mark all ranges as uploaded
+    */
+    void clear();
+
+    /**
+    *  @brief
+    *    Check if no range is modified
+    *
+    *  @return
+    *    'true' if no range has been added since the last clear(), else 'false'
+    */
+    bool empty() const;
+
+    /**
+    *  @brief
+    *    Get merged modified ranges
+    *
+    *  @return
+    *    Sorted, disjoint ranges (begin, end) that cover all added ranges
+    */
+    const std::vector<std::pair<std::size_t, std::size_t>> & ranges() const;
+
+    /**
+    *  @brief
+    *    Get number of elements covered by the merged ranges
+    *
+    *  @return
+    *    Number of elements to upload
+    */
+    std::size_t size() const;
+
+
+protected:
+    /**
+    *  @brief
+    *    Sort and merge the added ranges in place
+    */
+    void merge() const;
+
+
+protected:
+    std::size_t                                              m_mergeDistance; ///< Maximum number of clean elements between merged ranges
+    mutable std::vector<std::pair<std::size_t, std::size_t>> m_ranges;        ///< Added ranges, merged if m_merged is set
+    mutable bool                                             m_merged;        ///< Are the ranges sorted and merged?
+};
+
+
+} // namespace openll
@@ -0,0 +1,114 @@
+
+#include "DrawBatches.h"
+
+#include <algorithm>
+#include <functional>
+
+
+namespace openll
+{
+
+
+DrawBatches::DrawBatches()
+{
+}
+
+DrawBatches::~DrawBatches()
+{
+}
+
+void DrawBatches::clear()
+{
+    m_entries.clear();
+    m_batches.clear();
+}
+
+void DrawBatches::add(const void * texture, const void * vao, const bool shared, const std::size_t index)
+{
+    // Entries without texture or vertex array cannot be drawn
+    if (!texture || !vao)
+    {
+        return;
+    }
+
+    m_entries.push_back({ texture, vao, shared, index });
+}
+
+void DrawBatches::build()
+{
+    // Pointers of unrelated objects are only totally ordered by std::less
+    const auto less = std::less<const void *>();
+
+    std::sort(m_entries.begin(), m_entries.end(), [&less](const Entry & lhs, const Entry & rhs)
+    {
+        if (lhs.texture != rhs.texture)
+        {
+            return less(lhs.texture, rhs.texture);
+        }
+
+        if (lhs.vao != rhs.vao)
+        {
+            return less(lhs.vao, rhs.vao);
+        }
+
+        return lhs.index < rhs.index;
+    });
+
+    m_batches.clear();
+
+    for (auto begin = std::size_t(0); begin < m_entries.size(); )
+    {
+        const auto & entry = m_entries[begin];
+
+        // Entries of the same arena page that use the same texture
+        auto end = begin + 1;
+
+        if (entry.shared)
+        {
+            while (end < m_entries.size() && m_entries[end].texture == entry.texture && m_entries[end].vao == entry.vao)
+            {
+                ++end;
+            }
+        }
+
+        const auto bindTexture = m_batches.empty() || m_entries[m_batches.back().begin].texture != entry.texture;
+
+        m_batches.push_back({ begin, end, bindTexture });
+
+        begin = end;
+    }
+}
+
+const std::vector<DrawBatches::Entry> & DrawBatches::entries() const
+{
+    return m_entries;
+}
+
+const std::vector<DrawBatches::Batch> & DrawBatches::batches() const
+{
+    return m_batches;
+}
+
+GlyphRenderer::Statistics DrawBatches::statistics() const
+{
+    auto statistics = GlyphRenderer::Statistics{ 0, 0, 0, 0, 0 };
+
+    if (m_batches.empty())
+    {
+        return statistics;
+    }
+
+    statistics.numVertexClouds = m_entries.size();
+    statistics.numDrawCalls = m_batches.size();
+    statistics.numProgramChanges = 1;
+    statistics.numVertexArrayChanges = m_batches.size();
+    statistics.numTextureChanges = static_cast<std::size_t>(std::count_if(m_batches.begin(), m_batches.end(), [](const Batch & batch)
+    {
+        return batch.bindTexture;
+    }));
+
+    return statistics;
+}
+
+
+} // namespace openll
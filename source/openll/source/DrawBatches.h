@@ -0,0 +1,133 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+
+#include <openll/openll_api.h>
+#include <openll/GlyphRenderer.h>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Grouping of vertex clouds into draw calls
+*
+*    Entries are sorted by glyph texture and vertex array, so each texture
+*    and vertex array is bound once per group. Consecutive entries that
+*    share the vertex array of an arena page and use the same texture are
+*    combined into a single batch, to be drawn by a multi-draw call. Within
+*    a group, entries keep the order in which they have been added.
+*
+*    Used by GlyphRenderer. Textures and vertex arrays are only compared
+*    as keys, so no OpenGL context is required.
+*/
+class OPENLL_API DrawBatches
+{
+public:
+    /**
+    *  @brief
+    *    Vertex cloud to be drawn
+    */
+    struct Entry
+    {
+        const void * texture; ///< Glyph texture
+        const void * vao;     ///< Vertex array
+        bool         shared;  ///< Is the vertex array shared with other entries (see GlyphVertexArena)?
+        std::size_t  index;   ///< Index of the vertex cloud in the rendered list
+    };
+
+    /**
+    *  @brief
+    *    Range of entries drawn by a single draw call
+    */
+    struct Batch
+    {
+        std::size_t begin;       ///< Index of the first entry
+        std::size_t end;         ///< Index behind the last entry
+        bool        bindTexture; ///< Does the texture differ from the one of the previous batch?
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    DrawBatches();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~DrawBatches();
+
+    /**
+    *  @brief
+    *    Remove all entries and batches
+    */
+    void clear();
+
+    /**
+    *  @brief
+    *    Add a vertex cloud to be drawn
+    *
+    *  @param[in] texture
+    *    Glyph texture
+    *  @param[in] vao
+    *    Vertex array
+    *  @param[in] shared
+    *    Is the vertex array shared with other entries?
+    *  @param[in] index
+    *    Index of the vertex cloud in the rendered list
+    *
+    *  @remarks
+    *    Vertex clouds without texture or vertex array are ignored, as they cannot be drawn.
+    */
+    void add(const void * texture, const void * vao, bool shared, std::size_t index);
+
+    /**
+    *  @brief
+    *    Sort the entries and group them into batches
+    */
+    void build();
+
+    /**
+    *  @brief
+    *    Get entries
+    *
+    *  @return
+    *    Added entries, sorted after build()
+    */
+    const std::vector<Entry> & entries() const;
+
+    /**
+    *  @brief
+    *    Get batches
+    *
+    *  @return
+    *    Batches in drawing order, created by build()
+    */
+    const std::vector<Batch> & batches() const;
+
+    /**
+    *  @brief
+    *    Get number of state changes and draw calls needed to draw the batches
+    *
+    *  @return
+    *    Statistics of rendering the batches with a single program
+    */
+    GlyphRenderer::Statistics statistics() const;
+
+
+protected:
+    std::vector<Entry> m_entries; ///< Vertex clouds to be drawn
+    std::vector<Batch> m_batches; ///< Ranges of entries drawn by a single draw call
+};
+
+
+} // namespace openll
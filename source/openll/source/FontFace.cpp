@@ -1,6 +1,58 @@
 
 #include <openll/FontFace.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <glm/common.hpp>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/Texture.h>
+
+
+namespace
+{
+
+
+std::uint64_t nextGeneration()
+{
+    static std::atomic<std::uint64_t> generation(0);
+
+    return ++generation;
+}
+
+
+// Glyph indices of the basic multilingual plane are mapped by a flat table, higher code points by pages
+const std::size_t numFlatIndices = 0x10000;
+const std::size_t numIndices     = 0x110000;
+const std::size_t pageSize       = 256;
+
+// Kernings are stored in fixed point with 6 fractional bits (1/64 pt), covering +-512 pt
+const float kerningScale = 64.0f;
+
+
+// Bit of a subsequent glyph index within the kerning mask of a glyph
+std::uint64_t kerningBit(const std::uint32_t index)
+{
+    return std::uint64_t(1) << (index % 64);
+}
+
+// Kerning in fixed point, saturated to the representable range
+std::int16_t kerningAmount(const float kerning)
+{
+    return static_cast<std::int16_t>(std::round(glm::clamp(kerning * kerningScale, -32768.0f, 32767.0f)));
+}
+
+
+} // namespace
+
 
 namespace openll
 {
@@ -10,7 +62,16 @@ FontFace::FontFace()
 : m_ascent (0.0f)
 , m_descent(0.0f)
 , m_linegap(0.0f)
+, m_kerningIndexData(nullptr)
+, m_kerningAmountData(nullptr)
+, m_kerningCount(0)
+, m_generation(nextGeneration())
+, m_glyphTextureRows(0)
+, m_glyphMetricsModified(false)
 {
+    // Missing glyphs resolve to the empty glyph with id 0
+    m_glyphs.emplace_back(this);
+    m_glyphMetrics.resize(1);
 }
 
 FontFace::~FontFace()
@@ -118,76 +179,140 @@ void FontFace::setGlyphTexturePadding(const glm::vec4 & padding)
     m_glyphTexturePadding = padding;
 }
 
+const GlyphAtlas & FontFace::glyphAtlas() const
+{
+    return m_glyphAtlas;
+}
+
+void FontFace::setGlyphAtlas(GlyphAtlas && atlas)
+{
+    m_glyphAtlas = std::move(atlas);
+    m_glyphTexture.reset();
+}
+
 globjects::Texture * FontFace::glyphTexture() const
 {
+    // Upload all rows that are not yet uploaded
+    uploadGlyphTexture(std::numeric_limits<std::size_t>::max());
+
     return m_glyphTexture.get();
 }
 
+bool FontFace::uploadGlyphTexture(const std::size_t maxBytes) const
+{
+    const auto & extent = m_glyphAtlas.extent();
+
+    if (m_glyphAtlas.empty() || (m_glyphTexture && m_glyphTextureRows >= extent.y))
+    {
+        return true;
+    }
+
+    const auto rgba = m_glyphAtlas.format() == GlyphAtlas::Format::RGBA8;
+    const auto format = rgba ? gl::GL_RGBA : gl::GL_RED;
+
+    if (!m_glyphTexture)
+    {
+        auto texture = cppassist::make_unique<globjects::Texture>(gl::GL_TEXTURE_2D);
+
+        texture->image2D(0, rgba ? gl::GL_RGBA8 : gl::GL_R8, extent, 0, format, gl::GL_UNSIGNED_BYTE, nullptr);
+
+        texture->setParameter(gl::GL_TEXTURE_MIN_FILTER, gl::GL_LINEAR);
+        texture->setParameter(gl::GL_TEXTURE_MAG_FILTER, gl::GL_LINEAR);
+        texture->setParameter(gl::GL_TEXTURE_WRAP_S, gl::GL_CLAMP_TO_EDGE);
+        texture->setParameter(gl::GL_TEXTURE_WRAP_T, gl::GL_CLAMP_TO_EDGE);
+
+        m_glyphTexture = std::move(texture);
+        m_glyphTextureRows = 0;
+    }
+
+    // Upload a band of complete rows, at least one to make progress
+    const auto rowSize = std::size_t(extent.x) * m_glyphAtlas.bytesPerPixel();
+    const auto rows = static_cast<unsigned int>(std::min<std::size_t>(std::max<std::size_t>(maxBytes / rowSize, 1), extent.y - m_glyphTextureRows));
+
+    // Rows are not padded to four bytes, the alignment of the caller is restored afterwards
+    auto alignment = gl::GLint(4);
+    gl::glGetIntegerv(gl::GL_UNPACK_ALIGNMENT, &alignment);
+
+    gl::glPixelStorei(gl::GL_UNPACK_ALIGNMENT, 1);
+    m_glyphTexture->subImage2D(0, glm::ivec2(0, m_glyphTextureRows), glm::ivec2(extent.x, rows)
+        , format, gl::GL_UNSIGNED_BYTE, m_glyphAtlas.data() + m_glyphTextureRows * rowSize);
+    gl::glPixelStorei(gl::GL_UNPACK_ALIGNMENT, alignment);
+
+    m_glyphTextureRows += rows;
+
+    return m_glyphTextureRows >= extent.y;
+}
+
 void FontFace::setGlyphTexture(std::unique_ptr<globjects::Texture> && texture)
 {
     m_glyphTexture = std::move(texture);
+
+    // A texture that is set explicitly is complete
+    m_glyphTextureRows = m_glyphAtlas.extent().y;
 }
 
 bool FontFace::hasGlyph(const size_t index) const
 {
-    return m_glyphs.find(index) != m_glyphs.cend();
+    return glyphId(index) != 0;
 }
 
 Glyph & FontFace::glyph(const size_t index)
 {
-    const auto & existing = m_glyphs.find(index);
+    auto id = glyphId(index);
 
-    if (existing != m_glyphs.cend())
+    if (id == 0)
     {
-        return existing->second;
+        auto glyph = Glyph(this);
+        glyph.setIndex(index);
+
+        id = insertGlyph(std::move(glyph));
+
+        m_generation = nextGeneration();
     }
 
-    auto glyph = Glyph(this);
-    glyph.setIndex(index);
+    // The glyph metrics (and the generation, if they changed) are updated on next access, as the glyph might be modified
+    if (m_modifiedGlyphIds.empty() || m_modifiedGlyphIds.back() != id)
+    {
+        m_modifiedGlyphIds.push_back(id);
+    }
 
-    const auto inserted = m_glyphs.emplace(glyph.index(), std::move(glyph));
+    m_glyphMetricsModified.store(true, std::memory_order_release);
 
-    return inserted.first->second;
+    return m_glyphs[id];
 }
 
 const Glyph & FontFace::glyph(const size_t index) const
 {
-    static const auto empty = Glyph(this);
-
-    const auto & existing = m_glyphs.find(index);
-    if (existing != m_glyphs.cend())
-    {
-        return existing->second;
-    }
-
-    return empty;
+    return m_glyphs[glyphId(index)];
 }
 
 void FontFace::addGlyph(const Glyph & glyph)
 {
-    assert(m_glyphs.find(glyph.index()) == m_glyphs.cend());
+    assert(!hasGlyph(glyph.index()));
 
     Glyph copy = glyph;
-    copy.setFontFace(this);
-    m_glyphs.emplace(glyph.index(), std::move(copy));
+    insertGlyph(std::move(copy));
+
+    m_generation = nextGeneration();
 }
 
 void FontFace::addGlyph(Glyph && glyph)
 {
-    assert(m_glyphs.find(glyph.index()) == m_glyphs.cend());
+    assert(!hasGlyph(glyph.index()));
 
-    glyph.setFontFace(this);
-    m_glyphs.emplace(glyph.index(), std::move(glyph));
+    insertGlyph(std::move(glyph));
+
+    m_generation = nextGeneration();
 }
 
 std::vector<size_t> FontFace::glyphs() const
 {
     auto glyphs = std::vector<size_t>();
-    glyphs.reserve(m_glyphs.size());
+    glyphs.reserve(m_glyphs.size() - 1);
 
-    for (const auto & i : m_glyphs)
+    for (auto i = m_glyphs.cbegin() + 1; i != m_glyphs.cend(); ++i)
     {
-        glyphs.push_back(i.first);
+        glyphs.push_back(i->index());
     }
 
     return glyphs;
@@ -198,28 +323,34 @@ bool FontFace::depictable(const size_t index) const
     return glyph(index).depictable();
 }
 
+bool FontFace::hasKerning() const
+{
+    return m_kerningCount > 0;
+}
+
 float FontFace::kerning(const size_t index, const size_t subsequentIndex) const
 {
-    if (index == std::get<0>(m_kerningRequestCache) && subsequentIndex == std::get<1>(m_kerningRequestCache))
+    const auto id = glyphId(index);
+    const auto key = static_cast<std::uint32_t>(subsequentIndex);
+
+    // Most glyph pairs are not kerned, which is mostly detected by the mask of the glyph's run
+    if (id >= m_kerningMasks.size() || (m_kerningMasks[id] & kerningBit(key)) == 0)
     {
-        return std::get<2>(m_kerningRequestCache);
+        return 0.0f;
     }
 
-    const auto key = kerningIndex(index, subsequentIndex);
+    const auto begin = m_kerningOffsets[id];
+    const auto count = m_kerningOffsets[id + 1] - begin;
 
-    const auto it = m_kernings.find(key);
+    // Branch-free binary search within the run of the glyph
+    const auto * base = m_kerningIndexData + begin;
 
-    auto kerning = 0.0f;
-    if (it != m_kernings.cend())
+    for (auto n = count; n > 1; n -= n / 2)
     {
-        kerning = it->second;
+        base = base[n / 2] <= key ? base + n / 2 : base;
     }
 
-    std::get<0>(m_kerningRequestCache) = index;
-    std::get<1>(m_kerningRequestCache) = subsequentIndex;
-    std::get<2>(m_kerningRequestCache) = kerning;
-
-    return kerning;
+    return *base == key ? m_kerningAmountData[base - m_kerningIndexData] / kerningScale : 0.0f;
 }
 
 void FontFace::setKerning(const size_t index, const size_t subsequentIndex, const float kerning)
@@ -227,14 +358,316 @@ void FontFace::setKerning(const size_t index, const size_t subsequentIndex, cons
     assert(hasGlyph(index));
     assert(hasGlyph(subsequentIndex));
 
-    const auto key = kerningIndex(index, subsequentIndex);
+    // Pairs of missing glyphs are dropped, as they would apply to all missing glyphs
+    if (!hasGlyph(index) || !hasGlyph(subsequentIndex))
+    {
+        return;
+    }
+
+    const auto id = glyphId(index);
+    const auto key = static_cast<std::uint32_t>(subsequentIndex);
+    const auto amount = kerningAmount(kerning);
+
+    detachKernings();
+
+    if (id >= m_kerningMasks.size())
+    {
+        m_kerningOffsets.resize(m_glyphs.size() + 1, static_cast<std::uint32_t>(m_kerningIndices.size()));
+        m_kerningMasks.resize(m_glyphs.size(), 0);
+    }
+
+    // Keep the run of the glyph sorted by subsequent index; font files usually list kernings in order, so this appends
+    const auto begin = m_kerningIndices.begin() + m_kerningOffsets[id];
+    const auto end = m_kerningIndices.begin() + m_kerningOffsets[id + 1];
+    const auto it = std::lower_bound(begin, end, key);
+    const auto position = it - m_kerningIndices.begin();
+
+    if (it != end && *it == key)
+    {
+        m_kerningAmounts[position] = amount;
+    }
+    else
+    {
+        m_kerningMasks[id] |= kerningBit(key);
+        m_kerningIndices.insert(it, key);
+        m_kerningAmounts.insert(m_kerningAmounts.begin() + position, amount);
+
+        for (auto i = m_kerningOffsets.begin() + id + 1; i != m_kerningOffsets.end(); ++i)
+        {
+            ++*i;
+        }
+    }
+
+    m_kerningIndexData = m_kerningIndices.data();
+    m_kerningAmountData = m_kerningAmounts.data();
+    m_kerningCount = m_kerningIndices.size();
+
+    m_generation = nextGeneration();
+}
+
+void FontFace::setKernings(std::vector<std::uint32_t> && offsets, std::vector<std::uint32_t> && indices, std::vector<std::int16_t> && amounts)
+{
+    assert(indices.size() == amounts.size());
+
+    const auto count = indices.size();
+
+    m_kerningIndices = std::move(indices);
+    m_kerningAmounts = std::move(amounts);
+
+    setKerningData(std::move(offsets), m_kerningIndices.data(), m_kerningAmounts.data(), count);
+}
+
+void FontFace::referenceKernings(std::vector<std::uint32_t> && offsets, const std::uint32_t * indices, const std::int16_t * amounts, const std::size_t count)
+{
+    m_kerningIndices = std::vector<std::uint32_t>();
+    m_kerningAmounts = std::vector<std::int16_t>();
+
+    setKerningData(std::move(offsets), indices, amounts, count);
+}
+
+void FontFace::setKerningData(std::vector<std::uint32_t> && offsets, const std::uint32_t * indices, const std::int16_t * amounts, const std::size_t count)
+{
+    assert(offsets.empty() || offsets.size() == m_glyphs.size() + 1);
+    assert(offsets.empty() || offsets.back() == count);
+
+    m_kerningOffsets = std::move(offsets);
+    m_kerningIndexData = indices;
+    m_kerningAmountData = amounts;
+    m_kerningCount = count;
+
+    m_kerningMasks.assign(m_kerningOffsets.empty() ? 0 : m_glyphs.size(), 0);
+
+    for (auto id = size_t(0); id < m_kerningMasks.size(); ++id)
+    {
+        for (auto i = m_kerningOffsets[id]; i != m_kerningOffsets[id + 1]; ++i)
+        {
+            m_kerningMasks[id] |= kerningBit(m_kerningIndexData[i]);
+        }
+    }
+
+    m_generation = nextGeneration();
+}
+
+void FontFace::detachKernings()
+{
+    // Kernings in external storage are copied on first modification
+    if (m_kerningIndexData == m_kerningIndices.data())
+    {
+        return;
+    }
+
+    m_kerningIndices.assign(m_kerningIndexData, m_kerningIndexData + m_kerningCount);
+    m_kerningAmounts.assign(m_kerningAmountData, m_kerningAmountData + m_kerningCount);
+
+    m_kerningIndexData = m_kerningIndices.data();
+    m_kerningAmountData = m_kerningAmounts.data();
+}
+
+void FontFace::setKernings(const std::vector<std::uint32_t> & indices, const std::vector<std::uint32_t> & subsequentIndices, const std::vector<float> & kernings)
+{
+    assert(indices.size() == subsequentIndices.size());
+    assert(indices.size() == kernings.size());
+
+    const auto numPairs = std::min(indices.size(), std::min(subsequentIndices.size(), kernings.size()));
+
+    // Distribute the pairs to the runs of their glyphs, keeping the order of the pairs within each run
+    auto ids = std::vector<std::uint32_t>(numPairs);
+    auto offsets = std::vector<std::uint32_t>(m_glyphs.size() + 1, 0);
+
+    for (auto i = size_t(0); i < numPairs; ++i)
+    {
+        assert(hasGlyph(indices[i]));
+        assert(hasGlyph(subsequentIndices[i]));
+
+        // Pairs of missing glyphs are dropped, as they would apply to all missing glyphs
+        ids[i] = hasGlyph(subsequentIndices[i]) ? glyphId(indices[i]) : 0;
+
+        if (ids[i] != 0)
+        {
+            ++offsets[ids[i] + 1];
+        }
+    }
+
+    for (auto id = size_t(0); id < m_glyphs.size(); ++id)
+    {
+        offsets[id + 1] += offsets[id];
+    }
+
+    // Entries are (subsequent index, pair), so sorting a run puts the last of equal pairs last
+    auto entries = std::vector<std::pair<std::uint32_t, std::uint32_t>>(numPairs);
+    auto positions = std::vector<std::uint32_t>(offsets.begin(), offsets.end() - 1);
+
+    for (auto i = size_t(0); i < numPairs; ++i)
+    {
+        if (ids[i] == 0)
+        {
+            continue;
+        }
+
+        entries[positions[ids[i]]++] = std::make_pair(subsequentIndices[i], static_cast<std::uint32_t>(i));
+    }
+
+    auto kerningIndices = std::vector<std::uint32_t>();
+    auto kerningAmounts = std::vector<std::int16_t>();
+
+    kerningIndices.reserve(numPairs);
+    kerningAmounts.reserve(numPairs);
+
+    for (auto id = size_t(0); id < m_glyphs.size(); ++id)
+    {
+        const auto begin = entries.begin() + offsets[id];
+        const auto end = entries.begin() + offsets[id + 1];
+
+        std::sort(begin, end);
+
+        // Later pairs override earlier pairs, like repeated calls to setKerning()
+        offsets[id] = static_cast<std::uint32_t>(kerningIndices.size());
+
+        for (auto it = begin; it != end; ++it)
+        {
+            if (it + 1 != end && (it + 1)->first == it->first)
+            {
+                continue;
+            }
+
+            kerningIndices.push_back(it->first);
+            kerningAmounts.push_back(kerningAmount(kernings[it->second]));
+        }
+    }
+
+    offsets.back() = static_cast<std::uint32_t>(kerningIndices.size());
+
+    setKernings(std::move(offsets), std::move(kerningIndices), std::move(kerningAmounts));
+}
+
+std::uint64_t FontFace::generation() const
+{
+    // Apply modifications of mutably accessed glyphs first
+    glyphMetrics();
+
+    return m_generation;
+}
+
+const GlyphMetricsTable & FontFace::glyphMetrics() const
+{
+    // Glyphs can only be modified exclusively, so concurrent readers either all see modifications or none
+    if (m_glyphMetricsModified.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(m_glyphMetricsMutex);
+
+        auto changed = false;
+
+        for (const auto id : m_modifiedGlyphIds)
+        {
+            changed = m_glyphMetrics.setGlyph(id, m_glyphs[id]) || changed;
+        }
+
+        // Mutable accesses that did not change any glyph keep cached layouts valid
+        if (changed)
+        {
+            m_generation = nextGeneration();
+        }
+
+        m_modifiedGlyphIds.clear();
+        m_glyphMetricsModified.store(false, std::memory_order_release);
+    }
+
+    return m_glyphMetrics;
+}
+
+std::size_t FontFace::memoryUsage() const
+{
+    // External atlases and kernings (e.g., of embedded fonts) are not accounted for
+    const auto atlasSize = m_glyphAtlas.size();
+
+    auto size = sizeof(FontFace) + (m_glyphAtlas.external() ? 0 : atlasSize)
+        + m_glyphs.capacity() * sizeof(Glyph)
+        + (m_glyphIds.capacity() + m_pageIds.capacity() + m_pages.capacity()) * sizeof(std::uint32_t)
+        + (m_kerningOffsets.capacity() + m_kerningIndices.capacity()) * sizeof(std::uint32_t)
+        + m_kerningAmounts.capacity() * sizeof(std::int16_t)
+        + m_kerningMasks.capacity() * sizeof(std::uint64_t)
+        + m_glyphs.size() * (sizeof(float) + sizeof(std::uint8_t) + 2 * sizeof(glm::vec4) + sizeof(std::uint32_t));
+
+    // The glyph texture holds a copy of the atlas in video memory
+    if (m_glyphTexture)
+    {
+        size += atlasSize;
+    }
 
-    m_kernings[key] = kerning;
+    return size;
 }
 
-std::uint64_t FontFace::kerningIndex(char32_t firstIndex, char32_t secondIndex)
+std::uint32_t FontFace::glyphId(const size_t index) const
 {
-    return static_cast<std::uint64_t>(firstIndex) << 32 | static_cast<std::uint64_t>(secondIndex);
+    if (index < m_glyphIds.size())
+    {
+        return m_glyphIds[index];
+    }
+
+    if (index < numFlatIndices || index >= numIndices)
+    {
+        return 0;
+    }
+
+    const auto page = (index - numFlatIndices) / pageSize;
+
+    if (page >= m_pageIds.size() || m_pageIds[page] == 0)
+    {
+        return 0;
+    }
+
+    return m_pages[(m_pageIds[page] - 1) * pageSize + index % pageSize];
+}
+
+std::uint32_t FontFace::insertGlyph(Glyph && glyph)
+{
+    const auto index = glyph.index();
+
+    assert(index < numIndices);
+
+    // Glyphs beyond the unicode range cannot be looked up
+    if (index >= numIndices)
+    {
+        return 0;
+    }
+
+    const auto id = static_cast<std::uint32_t>(m_glyphs.size());
+
+    if (index < numFlatIndices)
+    {
+        if (index >= m_glyphIds.size())
+        {
+            // Grow to the next multiple of the page size, so fonts covering ASCII only need a single page
+            m_glyphIds.resize((index / pageSize + 1) * pageSize, 0);
+        }
+
+        m_glyphIds[index] = id;
+    }
+    else
+    {
+        const auto page = (index - numFlatIndices) / pageSize;
+
+        if (page >= m_pageIds.size())
+        {
+            m_pageIds.resize(page + 1, 0);
+        }
+
+        if (m_pageIds[page] == 0)
+        {
+            m_pages.resize(m_pages.size() + pageSize, 0);
+            m_pageIds[page] = static_cast<std::uint32_t>(m_pages.size() / pageSize);
+        }
+
+        m_pages[(m_pageIds[page] - 1) * pageSize + index % pageSize] = id;
+    }
+
+    glyph.setFontFace(this);
+    m_glyphs.push_back(std::move(glyph));
+
+    m_glyphMetrics.resize(m_glyphs.size());
+    m_glyphMetrics.setGlyph(id, m_glyphs.back());
+
+    return id;
 }
 
 
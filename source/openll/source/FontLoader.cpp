@@ -1,86 +1,483 @@
-
 #include <openll/FontLoader.h>
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 #include <string>
-#include <functional>
-#include <set>
-#include <map>
+#include <utility>
+#include <vector>
 
 #include <cppassist/memory/make_unique.h>
-#include <cppassist/logging/logging.h>
-#include <cppassist/string/conversion.h>
 #include <cppassist/string/manipulation.h>
 #include <cppassist/fs/RawFile.h>
 
 #include <cppfs/FilePath.h>
 
-#include <glbinding/gl/enum.h>
-
 #include <openll/FontFace.h>
+#include <openll/GlyphAtlas.h>
 
+#include "BinaryFont.h"
+#include "MappedFile.h"
 
-namespace openll
+
+namespace
 {
 
 
-std::unique_ptr<FontFace> FontLoader::load(const std::string & filename)
+// Line identifiers and keys of font description files
+enum class Token : unsigned int
+{
+    Unknown,
+    Info, Common, Page, Char, Kernings, Kerning,
+    Size, Padding,
+    LineHeight, Base, ScaleW, ScaleH,
+    File,
+    Id, X, Y, Width, Height, XOffset, YOffset, XAdvance,
+    First, Second, Amount, Count
+};
+
+// Bit of a token within a set of parsed keys
+unsigned int bit(const Token token)
+{
+    return 1u << static_cast<unsigned int>(token);
+}
+
+bool equals(const char * begin, const char * end, const char * identifier)
 {
-    // Open file
-    std::ifstream in(filename, std::ios::in | std::ios::binary);
-    if (!in)
+    return std::memcmp(begin, identifier, static_cast<std::size_t>(end - begin)) == 0;
+}
+
+// Identify a line identifier or key, dispatching on its length first
+Token identify(const char * begin, const char * end)
+{
+    switch (end - begin)
     {
-        return nullptr;
+    case 1:
+        return *begin == 'x' ? Token::X : *begin == 'y' ? Token::Y : Token::Unknown;
+    case 2:
+        return equals(begin, end, "id") ? Token::Id : Token::Unknown;
+    case 4:
+        return equals(begin, end, "char") ? Token::Char
+            : equals(begin, end, "info") ? Token::Info
+            : equals(begin, end, "page") ? Token::Page
+            : equals(begin, end, "size") ? Token::Size
+            : equals(begin, end, "base") ? Token::Base
+            : equals(begin, end, "file") ? Token::File
+            : Token::Unknown;
+    case 5:
+        return equals(begin, end, "first") ? Token::First
+            : equals(begin, end, "width") ? Token::Width
+            : equals(begin, end, "count") ? Token::Count
+            : Token::Unknown;
+    case 6:
+        return equals(begin, end, "second") ? Token::Second
+            : equals(begin, end, "amount") ? Token::Amount
+            : equals(begin, end, "height") ? Token::Height
+            : equals(begin, end, "common") ? Token::Common
+            : equals(begin, end, "scaleW") ? Token::ScaleW
+            : equals(begin, end, "scaleH") ? Token::ScaleH
+            : Token::Unknown;
+    case 7:
+        return equals(begin, end, "kerning") ? Token::Kerning
+            : equals(begin, end, "xoffset") ? Token::XOffset
+            : equals(begin, end, "yoffset") ? Token::YOffset
+            : equals(begin, end, "padding") ? Token::Padding
+            : Token::Unknown;
+    case 8:
+        return equals(begin, end, "xadvance") ? Token::XAdvance
+            : equals(begin, end, "kernings") ? Token::Kernings
+            : Token::Unknown;
+    case 10:
+        return equals(begin, end, "lineHeight") ? Token::LineHeight : Token::Unknown;
+    default:
+        return Token::Unknown;
     }
+}
 
-    // Create font face
-    auto fontFace = cppassist::make_unique<FontFace>();
+// Carriage returns are whitespace, so lines with Windows line endings need no stripping
+bool isSpace(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-    // Initialize font info
-    auto identifier = std::string();
-    auto fontSize   = 0.0f;
+/**
+*  @brief
+*    Read the next key-value pair of a line
+*
+*  @param[in,out] position
+*    Position within the line, advanced past the pair
+*  @param[in] end
+*    End of the line
+*  @param[out] key
+*    Identified key
+*  @param[out] value
+*    Value of the pair, without quotes
+*
+*  @return
+*    'true' if a pair was read, 'false' at the end of the line
+*/
+bool readPair(const char * & position, const char * end, Token & key, std::pair<const char *, const char *> & value)
+{
+    while (position != end && isSpace(*position))
+    {
+        ++position;
+    }
 
-    // Read file line by line
-    auto line = std::string();
-    while (std::getline(in, line))
+    if (position == end)
     {
-        // Read next line
-        std::stringstream ss;
-        ss << line;
+        return false;
+    }
 
-        // Read line identifier
-        if (!std::getline(ss, identifier, ' '))
+    const auto keyBegin = position;
+    while (position != end && *position != '=' && !isSpace(*position))
+    {
+        ++position;
+    }
+
+    key = identify(keyBegin, position);
+
+    if (position == end || *position != '=')
+    {
+        value = std::make_pair(position, position);
+        return true;
+    }
+
+    ++position;
+
+    // Quoted values may contain spaces
+    if (position != end && *position == '"')
+    {
+        const auto valueBegin = ++position;
+        while (position != end && *position != '"')
         {
-            assert(false);
-            continue;
+            ++position;
+        }
+
+        value = std::make_pair(valueBegin, position);
+
+        if (position != end)
+        {
+            ++position;
+        }
+
+        return true;
+    }
+
+    const auto valueBegin = position;
+    while (position != end && !isSpace(*position))
+    {
+        ++position;
+    }
+
+    value = std::make_pair(valueBegin, position);
+    return true;
+}
+
+/**
+*  @brief
+*    Parse a decimal number with optional sign and fraction
+*
+*  @param[in] begin
+*    First character of the number
+*  @param[in] end
+*    End of the value containing the number
+*  @param[out] number
+*    Parsed number, 0 if there are no digits
+*
+*  @return
+*    Position after the number
+*/
+const char * parseNumber(const char * begin, const char * end, float & number)
+{
+    auto position = begin;
+    const auto negative = position != end && *position == '-';
+
+    if (position != end && (*position == '-' || *position == '+'))
+    {
+        ++position;
+    }
+
+    auto value = 0.0;
+    while (position != end && *position >= '0' && *position <= '9')
+    {
+        value = value * 10.0 + (*position++ - '0');
+    }
+
+    if (position != end && *position == '.')
+    {
+        auto scale = 1.0;
+        for (++position; position != end && *position >= '0' && *position <= '9'; ++position)
+        {
+            scale *= 0.1;
+            value += (*position - '0') * scale;
         }
+    }
+
+    number = static_cast<float>(negative ? -value : value);
+    return position;
+}
+
+float toFloat(const std::pair<const char *, const char *> & value)
+{
+    auto number = 0.0f;
+    parseNumber(value.first, value.second, number);
 
-        // Parse line
-        if (identifier == "info")
+    return number;
+}
+
+// Length of the shortest kerning line, including its line feed
+constexpr auto minimalKerningLength = sizeof("kerning first=1 second=1 amount=0");
+
+// Negative or malformed indices yield 0, which is no valid glyph index
+std::uint32_t toIndex(const std::pair<const char *, const char *> & value)
+{
+    auto index = std::uint32_t(0);
+    for (auto position = value.first; position != value.second; ++position)
+    {
+        if (*position < '0' || *position > '9')
         {
-            parseInfo(ss, *fontFace, fontSize);
+            return 0;
         }
-        else if (identifier == "common")
+
+        index = index * 10 + static_cast<std::uint32_t>(*position - '0');
+    }
+
+    return index;
+}
+
+
+} // namespace
+
+
+namespace openll
+{
+
+
+std::unique_ptr<FontFace> FontLoader::load(const std::string & filename)
+{
+    // The whole file is mapped, so neither format requires copies of its contents
+    const MappedFile file(filename);
+    if (!file.isValid())
+    {
+        return nullptr;
+    }
+
+    // Precompiled binary font files are identified by their magic
+    if (file.size() >= sizeof(BinaryFont::magic) && std::memcmp(file.data(), BinaryFont::magic, sizeof(BinaryFont::magic)) == 0)
+    {
+        return loadBinary(file.data(), file.size());
+    }
+
+    const auto begin = reinterpret_cast<const char *>(file.data());
+
+    return loadDescription(begin, begin + file.size(), filename);
+}
+
+std::future<std::unique_ptr<FontFace>> FontLoader::loadAsync(const std::string & filename)
+{
+    return std::async(std::launch::async, [filename]()
+    {
+        return load(filename);
+    });
+}
+
+std::unique_ptr<FontFace> FontLoader::loadEmbedded(const unsigned char * data, const std::size_t size)
+{
+    return loadBinary(data, size, true);
+}
+
+std::unique_ptr<FontFace> FontLoader::loadBinary(const unsigned char * data, const std::size_t size, const bool reference)
+{
+    static_assert(sizeof(BinaryFont::Header) == 128, "Unexpected padding in binary font header");
+    static_assert(sizeof(BinaryFont::Glyph) == 40, "Unexpected padding in binary font glyph record");
+
+    if (size < sizeof(BinaryFont::Header))
+    {
+        return nullptr;
+    }
+
+    const auto & header = *reinterpret_cast<const BinaryFont::Header *>(data);
+
+    if (std::memcmp(header.magic, BinaryFont::magic, sizeof(header.magic)) != 0
+        || header.version != BinaryFont::version
+        || header.byteOrderMark != BinaryFont::byteOrderMark
+        || header.atlasFormat > static_cast<std::uint32_t>(GlyphAtlas::Format::RGBA8))
+    {
+        return nullptr;
+    }
+
+    // Check that all sections are aligned and within the file
+    const auto fits = [size](const std::uint64_t offset, const std::uint64_t sectionSize)
+    {
+        return offset % BinaryFont::sectionAlignment == 0 && offset <= size && sectionSize <= size - offset;
+    };
+
+    const auto glyphCount = std::uint64_t(header.glyphCount);
+    const auto kerningCount = std::uint64_t(header.kerningCount);
+
+    if (!fits(header.glyphsOffset, glyphCount * sizeof(BinaryFont::Glyph))
+        || !fits(header.kerningOffsetsOffset, (glyphCount + 2) * sizeof(std::uint32_t))
+        || !fits(header.kerningIndicesOffset, kerningCount * sizeof(std::uint32_t))
+        || !fits(header.kerningAmountsOffset, kerningCount * sizeof(std::int16_t))
+        || !fits(header.atlasOffset, header.atlasSize))
+    {
+        return nullptr;
+    }
+
+    const auto glyphs = reinterpret_cast<const BinaryFont::Glyph *>(data + header.glyphsOffset);
+    const auto kerningOffsets = reinterpret_cast<const std::uint32_t *>(data + header.kerningOffsetsOffset);
+    const auto kerningIndices = reinterpret_cast<const std::uint32_t *>(data + header.kerningIndicesOffset);
+    const auto kerningAmounts = reinterpret_cast<const std::int16_t *>(data + header.kerningAmountsOffset);
+
+    // Kerning runs have to be ordered and within the kerning table
+    for (auto id = std::uint64_t(0); id <= glyphCount; ++id)
+    {
+        if (kerningOffsets[id] > kerningOffsets[id + 1] || kerningOffsets[id + 1] > kerningCount)
         {
-            parseCommon(ss, *fontFace, fontSize);
+            return nullptr;
         }
-        else if (identifier == "page")
+    }
+
+    // The last run has to end with the kerning table
+    if (kerningCount > 0 && kerningOffsets[glyphCount + 1] != kerningCount)
+    {
+        return nullptr;
+    }
+
+    auto fontFace = cppassist::make_unique<FontFace>();
+
+    fontFace->setAscent(header.ascent);
+    fontFace->setDescent(header.descent);
+    fontFace->setLinegap(header.linegap);
+    fontFace->setGlyphTextureExtent(glm::uvec2(header.glyphTextureExtent[0], header.glyphTextureExtent[1]));
+    fontFace->setGlyphTexturePadding(glm::vec4(header.glyphTexturePadding[0], header.glyphTexturePadding[1]
+        , header.glyphTexturePadding[2], header.glyphTexturePadding[3]));
+
+    // Glyphs are added in order of their ids, so the ids of the kerning table remain valid
+    for (auto id = std::uint64_t(0); id < glyphCount; ++id)
+    {
+        const auto & record = glyphs[id];
+
+        if (fontFace->hasGlyph(record.index))
         {
-            parsePage(ss, *fontFace, filename);
+            return nullptr;
         }
-        else if (identifier == "char")
+
+        auto glyph = Glyph(nullptr);
+
+        glyph.setIndex(record.index);
+        glyph.setAdvance(record.advance);
+        glyph.setSubTextureOrigin(glm::vec2(record.subTextureOrigin[0], record.subTextureOrigin[1]));
+        glyph.setSubTextureExtent(glm::vec2(record.subTextureExtent[0], record.subTextureExtent[1]));
+        glyph.setBearing(glm::vec2(record.bearing[0], record.bearing[1]));
+        glyph.setExtent(glm::vec2(record.extent[0], record.extent[1]));
+
+        fontFace->addGlyph(std::move(glyph));
+    }
+
+    if (kerningCount > 0 && reference)
+    {
+        fontFace->referenceKernings(std::vector<std::uint32_t>(kerningOffsets, kerningOffsets + glyphCount + 2)
+            , kerningIndices, kerningAmounts, static_cast<std::size_t>(kerningCount));
+    }
+    else if (kerningCount > 0)
+    {
+        fontFace->setKernings(
+            std::vector<std::uint32_t>(kerningOffsets, kerningOffsets + glyphCount + 2)
+        ,   std::vector<std::uint32_t>(kerningIndices, kerningIndices + kerningCount)
+        ,   std::vector<std::int16_t>(kerningAmounts, kerningAmounts + kerningCount));
+    }
+
+    if (header.atlasSize > 0)
+    {
+        const auto extent = glm::uvec2(header.atlasExtent[0], header.atlasExtent[1]);
+        const auto format = static_cast<GlyphAtlas::Format>(header.atlasFormat);
+        const auto pixels = data + header.atlasOffset;
+
+        if (header.atlasSize != std::uint64_t(extent.x) * extent.y * (format == GlyphAtlas::Format::RGBA8 ? 4 : 1))
         {
-            parseChar(ss, *fontFace);
+            return nullptr;
         }
-        else if (identifier == "kerning")
+
+        fontFace->setGlyphAtlas(reference ? GlyphAtlas(extent, format, pixels)
+            : GlyphAtlas(extent, format, std::vector<unsigned char>(pixels, pixels + header.atlasSize)));
+    }
+
+    return fontFace;
+}
+
+std::unique_ptr<FontFace> FontLoader::loadDescription(const char * begin, const char * end, const std::string & filename)
+{
+    // Create font face
+    auto fontFace = cppassist::make_unique<FontFace>();
+
+    // Initialize font info
+    auto fontSize = 0.0f;
+
+    // Kernings are set at once, as setting them one by one is quadratic in the number of glyphs
+    auto kerningIndices = std::vector<std::uint32_t>();
+    auto kerningSubsequentIndices = std::vector<std::uint32_t>();
+    auto kernings = std::vector<float>();
+
+    // Read file line by line
+    for (auto lineBegin = begin; lineBegin != end; )
+    {
+        const auto newline = static_cast<const char *>(std::memchr(lineBegin, '\n', static_cast<std::size_t>(end - lineBegin)));
+        const auto lineEnd = newline ? newline : end;
+
+        // Read line identifier
+        auto position = lineBegin;
+        auto identifier = Token::Unknown;
+        auto value = std::pair<const char *, const char *>();
+
+        if (readPair(position, lineEnd, identifier, value))
         {
-            parseKerning(ss, *fontFace);
+            // Parse line
+            switch (identifier)
+            {
+            case Token::Info:
+                parseInfo(position, lineEnd, *fontFace, fontSize);
+                break;
+            case Token::Common:
+                parseCommon(position, lineEnd, *fontFace, fontSize);
+                break;
+            case Token::Page:
+                parsePage(position, lineEnd, *fontFace, filename);
+                break;
+            case Token::Char:
+                parseChar(position, lineEnd, *fontFace);
+                break;
+            case Token::Kernings:
+                // Reserve for the announced number of kernings, but not more than the remaining lines can hold
+                while (readPair(position, lineEnd, identifier, value))
+                {
+                    if (identifier == Token::Count)
+                    {
+                        const auto count = std::min(std::size_t(toIndex(value)), static_cast<std::size_t>(end - lineEnd) / minimalKerningLength);
+
+                        kerningIndices.reserve(count);
+                        kerningSubsequentIndices.reserve(count);
+                        kernings.reserve(count);
+                    }
+                }
+                break;
+            case Token::Kerning:
+                parseKerning(position, lineEnd, kerningIndices, kerningSubsequentIndices, kernings);
+                break;
+            default:
+                break;
+            }
         }
+
+        lineBegin = newline ? newline + 1 : end;
+    }
+
+    if (!kernings.empty())
+    {
+        fontFace->setKernings(kerningIndices, kerningSubsequentIndices, kernings);
     }
 
     // Check if font has been loaded successfully
-    if (fontFace->glyphTexture())
+    if (!fontFace->glyphAtlas().empty())
     {
         return fontFace;
     }
@@ -89,156 +486,257 @@ std::unique_ptr<FontFace> FontLoader::load(const std::string & filename)
     return nullptr;
 }
 
-void FontLoader::parseInfo(std::stringstream & stream, FontFace & fontFace, float & fontSize)
+void FontLoader::parseInfo(const char * begin, const char * end, FontFace & fontFace, float & fontSize)
 {
-    auto pairs = readKeyValuePairs(stream, { "size", "padding" });
+    auto key = Token::Unknown;
+    auto value = std::pair<const char *, const char *>();
+    auto keys = 0u;
+
+    auto values = glm::vec4();
+
+    while (readPair(begin, end, key, value))
+    {
+        switch (key)
+        {
+        case Token::Size:
+            fontSize = toFloat(value);
+            break;
+        case Token::Padding:
+        {
+            // Four comma-separated values
+            auto position = value.first;
+            for (auto i = 0; i < 4; ++i)
+            {
+                position = parseNumber(position, value.second, values[i]);
+                position += position != value.second ? 1 : 0;
+            }
+            break;
+        }
+        default:
+            continue;
+        }
 
-    fontSize = cppassist::string::fromString<float>(pairs.at("size"));
+        keys |= bit(key);
+    }
 
-    auto values = cppassist::string::split(pairs.at("padding"), ',', true);
-    assert(values.size() == 4);
+    if (keys != (bit(Token::Size) | bit(Token::Padding)))
+    {
+        assert(false);
+        return;
+    }
 
     auto padding = glm::vec4();
-    padding[0] = cppassist::string::fromString<float>(values[2]); // top
-    padding[1] = cppassist::string::fromString<float>(values[1]); // right
-    padding[2] = cppassist::string::fromString<float>(values[3]); // bottom
-    padding[3] = cppassist::string::fromString<float>(values[0]); // left
+    padding[0] = values[2]; // top
+    padding[1] = values[1]; // right
+    padding[2] = values[3]; // bottom
+    padding[3] = values[0]; // left
 
     fontFace.setGlyphTexturePadding(padding);
 }
 
-void FontLoader::parseCommon(std::stringstream & stream, FontFace & fontFace, const float fontSize)
+void FontLoader::parseCommon(const char * begin, const char * end, FontFace & fontFace, const float fontSize)
 {
-    auto pairs = readKeyValuePairs(stream, { "lineHeight", "base", "scaleW", "scaleH" });
+    auto key = Token::Unknown;
+    auto value = std::pair<const char *, const char *>();
+    auto keys = 0u;
+
+    auto lineHeight = 0.0f;
+    auto base = 0.0f;
+    auto extent = glm::vec2();
+
+    while (readPair(begin, end, key, value))
+    {
+        switch (key)
+        {
+        case Token::LineHeight:
+            lineHeight = toFloat(value);
+            break;
+        case Token::Base:
+            base = toFloat(value);
+            break;
+        case Token::ScaleW:
+            extent.x = toFloat(value);
+            break;
+        case Token::ScaleH:
+            extent.y = toFloat(value);
+            break;
+        default:
+            continue;
+        }
+
+        keys |= bit(key);
+    }
+
+    if (keys != (bit(Token::LineHeight) | bit(Token::Base) | bit(Token::ScaleW) | bit(Token::ScaleH)))
+    {
+        assert(false);
+        return;
+    }
 
-    fontFace.setAscent(cppassist::string::fromString<float>(pairs.at("base")));
+    fontFace.setAscent(base);
     fontFace.setDescent(fontFace.ascent() - fontSize);
 
     assert(fontFace.size() > 0.f);
-    fontFace.setLineHeight(cppassist::string::fromString<float>(pairs.at("lineHeight")));
+    fontFace.setLineHeight(lineHeight);
 
-    fontFace.setGlyphTextureExtent({
-        cppassist::string::fromString<float>(pairs.at("scaleW")),
-        cppassist::string::fromString<float>(pairs.at("scaleH"))
-    });
+    fontFace.setGlyphTextureExtent(extent);
 }
 
-void FontLoader::parsePage(std::stringstream & stream, FontFace & fontFace, const std::string & filename)
+void FontLoader::parsePage(const char * begin, const char * end, FontFace & fontFace, const std::string & filename)
 {
-    auto pairs = readKeyValuePairs(stream, { "file" });
-
-    const auto path = cppfs::FilePath(filename).directoryPath();
-    const auto file = cppassist::string::stripped(pairs.at("file"), { '"', '\r' });
+    auto key = Token::Unknown;
+    auto value = std::pair<const char *, const char *>();
+    auto file = std::string();
 
-    if (cppassist::string::hasSuffix(file, ".raw"))
+    while (readPair(begin, end, key, value))
     {
-        auto texture = new globjects::Texture(gl::GL_TEXTURE_2D);
-        auto raw = cppassist::RawFile();
-        raw.load(path + "/" + file);
-
-        if (!raw.isValid())
+        if (key == Token::File)
         {
-            assert(false);
-            return;
+            file.assign(value.first, value.second);
         }
+    }
+
+    if (!cppassist::string::hasSuffix(file, ".raw"))
+    {
+        return;
+    }
+
+    const auto path = cppfs::FilePath(filename).directoryPath();
 
-        texture->image2D(0, gl::GL_R8, fontFace.glyphTextureExtent(), 0
-            , gl::GL_RED, gl::GL_UNSIGNED_BYTE, raw.data());
+    auto raw = cppassist::RawFile();
+    raw.load(path + "/" + file);
 
-        fontFace.setGlyphTexture(std::unique_ptr<globjects::Texture>(texture));
+    const auto & extent = fontFace.glyphTextureExtent();
+
+    if (!raw.isValid() || raw.size() != std::size_t(extent.x) * extent.y)
+    {
+        assert(false);
+        return;
     }
 
-    fontFace.glyphTexture()->setParameter(gl::GL_TEXTURE_MIN_FILTER, gl::GL_LINEAR);
-    fontFace.glyphTexture()->setParameter(gl::GL_TEXTURE_MAG_FILTER, gl::GL_LINEAR);
-    fontFace.glyphTexture()->setParameter(gl::GL_TEXTURE_WRAP_S, gl::GL_CLAMP_TO_EDGE);
-    fontFace.glyphTexture()->setParameter(gl::GL_TEXTURE_WRAP_T, gl::GL_CLAMP_TO_EDGE);
+    // The texture is created from the atlas on first use, so no OpenGL context is required here
+    auto pixels = std::vector<unsigned char>(raw.data(), raw.data() + raw.size());
+
+    fontFace.setGlyphAtlas(GlyphAtlas(extent, GlyphAtlas::Format::R8, std::move(pixels)));
 }
 
-void FontLoader::parseChar(std::stringstream & stream, FontFace & fontFace)
+void FontLoader::parseChar(const char * begin, const char * end, FontFace & fontFace)
 {
-    auto pairs = readKeyValuePairs(stream, { "id", "x", "y", "width", "height", "xoffset", "yoffset", "xadvance" });
+    auto key = Token::Unknown;
+    auto value = std::pair<const char *, const char *>();
+    auto keys = 0u;
+
+    auto index = std::uint32_t(0);
+    auto origin = glm::vec2();
+    auto extent = glm::vec2();
+    auto offset = glm::vec2();
+    auto advance = 0.0f;
+
+    while (readPair(begin, end, key, value))
+    {
+        switch (key)
+        {
+        case Token::Id:
+            index = toIndex(value);
+            break;
+        case Token::X:
+            origin.x = toFloat(value);
+            break;
+        case Token::Y:
+            origin.y = toFloat(value);
+            break;
+        case Token::Width:
+            extent.x = toFloat(value);
+            break;
+        case Token::Height:
+            extent.y = toFloat(value);
+            break;
+        case Token::XOffset:
+            offset.x = toFloat(value);
+            break;
+        case Token::YOffset:
+            offset.y = toFloat(value);
+            break;
+        case Token::XAdvance:
+            advance = toFloat(value);
+            break;
+        default:
+            continue;
+        }
+
+        keys |= bit(key);
+    }
 
-    auto index = cppassist::string::fromString<size_t>(pairs.at("id"));
-    assert(index > 0);
+    const auto mandatoryKeys = bit(Token::Id) | bit(Token::X) | bit(Token::Y) | bit(Token::Width) | bit(Token::Height)
+        | bit(Token::XOffset) | bit(Token::YOffset) | bit(Token::XAdvance);
+
+    if (keys != mandatoryKeys || index == 0)
+    {
+        assert(false);
+        return;
+    }
 
     auto glyph = Glyph(nullptr);
 
     glyph.setIndex(index);
 
     const auto extentScale = 1.f / glm::vec2(fontFace.glyphTextureExtent());
-    const auto extent = glm::vec2(
-        cppassist::string::fromString<float>(pairs.at("width")),
-        cppassist::string::fromString<float>(pairs.at("height"))
-    );
 
     glyph.setSubTextureOrigin({
-        cppassist::string::fromString<float>(pairs.at("x")) * extentScale.x,
-        1.f - (cppassist::string::fromString<float>(pairs.at("y")) + extent.y) * extentScale.y
+        origin.x * extentScale.x,
+        1.f - (origin.y + extent.y) * extentScale.y
     });
 
     glyph.setExtent(extent);
     glyph.setSubTextureExtent(extent * extentScale);
 
-    glyph.setBearing(fontFace.ascent(),
-        cppassist::string::fromString<float>(pairs.at("xoffset")),
-        cppassist::string::fromString<float>(pairs.at("yoffset"))
-    );
+    glyph.setBearing(fontFace.ascent(), offset.x, offset.y);
 
-    glyph.setAdvance(cppassist::string::fromString<float>(pairs.at("xadvance")));
+    glyph.setAdvance(advance);
 
     fontFace.addGlyph(glyph);
 }
 
-void FontLoader::parseKerning(std::stringstream & stream, FontFace & fontFace)
+void FontLoader::parseKerning(const char * begin, const char * end
+    , std::vector<std::uint32_t> & indices, std::vector<std::uint32_t> & subsequentIndices, std::vector<float> & kernings)
 {
-    auto pairs = readKeyValuePairs(stream, { "first", "second", "amount" });
+    auto key = Token::Unknown;
+    auto value = std::pair<const char *, const char *>();
+    auto keys = 0u;
 
-    auto first = cppassist::string::fromString<size_t>(pairs.at("first"));
-    assert(first > 0);
+    auto first = std::uint32_t(0);
+    auto second = std::uint32_t(0);
+    auto kerning = 0.0f;
 
-    auto second = cppassist::string::fromString<size_t>(pairs.at("second"));
-    assert(second > 0);
-
-    auto kerning = cppassist::string::fromString<float>(pairs.at("amount"));
-
-    fontFace.setKerning(first, second, kerning);
-}
-
-std::map<std::string, std::string> FontLoader::readKeyValuePairs(std::stringstream & stream, const std::initializer_list<const char *> & mandatoryKeys)
-{
-    auto key = std::string();
-    auto value = std::string();
-
-    auto pairs = std::map<std::string, std::string>();
-
-    while (stream)
+    while (readPair(begin, end, key, value))
     {
-        if (!std::getline(stream, key, '='))
+        switch (key)
         {
+        case Token::First:
+            first = toIndex(value);
+            break;
+        case Token::Second:
+            second = toIndex(value);
+            break;
+        case Token::Amount:
+            kerning = toFloat(value);
+            break;
+        default:
             continue;
         }
 
-        if (!std::getline(stream, value, ' '))
-        {
-            continue;
-        }
-
-        pairs.insert(std::pair<std::string, std::string>(key, value));
-    }
-
-    // Check if all required keys are provided
-    auto valid = true;
-    for (const auto mandatoryKey : mandatoryKeys)
-    {
-        valid |= (pairs.find(mandatoryKey) != pairs.cend());
+        keys |= bit(key);
     }
 
-    if (!valid)
+    if (keys != (bit(Token::First) | bit(Token::Second) | bit(Token::Amount)) || first == 0 || second == 0)
     {
-        return std::map<std::string, std::string>();
+        assert(false);
+        return;
     }
 
-    return pairs;
+    indices.push_back(first);
+    subsequentIndices.push_back(second);
+    kernings.push_back(kerning);
 }
 
 
@@ -0,0 +1,197 @@
+
+#include <openll/FontRegistry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#else
+#include <limits.h>
+#include <stdlib.h>
+#endif
+
+#include <openll/FontFace.h>
+#include <openll/FontLoader.h>
+
+
+namespace openll
+{
+
+
+FontRegistry::FontRegistry(const std::size_t memoryBudget)
+: m_memoryBudget(memoryBudget)
+, m_memoryUsage(0)
+, m_accessCount(0)
+{
+}
+
+FontRegistry::~FontRegistry()
+{
+}
+
+std::shared_ptr<FontFace> FontRegistry::get(const std::string & filename)
+{
+    const auto key = canonicalPath(filename);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        it->second.lastAccess = ++m_accessCount;
+
+        // Wait on a copy of the future, as the entry may be removed meanwhile
+        const auto face = it->second.face;
+        lock.unlock();
+
+        return face.get();
+    }
+
+    // Register the font face as being loaded, so concurrent requests wait for it
+    std::promise<std::shared_ptr<FontFace>> promise;
+
+    auto entry = Entry();
+    entry.face = promise.get_future().share();
+    entry.memoryUsage = 0;
+    entry.lastAccess = ++m_accessCount;
+
+    m_entries.emplace(key, std::move(entry));
+
+    // Load without holding the lock, so other font faces can be requested meanwhile
+    lock.unlock();
+    auto face = std::shared_ptr<FontFace>(FontLoader::load(filename));
+    promise.set_value(face);
+    lock.lock();
+
+    // Only the loading thread removes a pending entry
+    it = m_entries.find(key);
+
+    if (!face)
+    {
+        m_entries.erase(it);
+
+        return face;
+    }
+
+    it->second.memoryUsage = face->memoryUsage();
+    m_memoryUsage += it->second.memoryUsage;
+
+    evict(m_memoryBudget);
+
+    return face;
+}
+
+bool FontRegistry::contains(const std::string & filename) const
+{
+    const auto key = canonicalPath(filename);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_entries.find(key) != m_entries.end();
+}
+
+std::size_t FontRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_entries.size();
+}
+
+std::size_t FontRegistry::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_memoryUsage;
+}
+
+std::size_t FontRegistry::memoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_memoryBudget;
+}
+
+void FontRegistry::setMemoryBudget(const std::size_t memoryBudget)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_memoryBudget = memoryBudget;
+
+    evict(m_memoryBudget);
+}
+
+std::size_t FontRegistry::collect()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return evict(0);
+}
+
+std::size_t FontRegistry::evict(const std::size_t memoryBudget)
+{
+    if (m_memoryUsage <= memoryBudget)
+    {
+        return 0;
+    }
+
+    using Candidate = std::pair<std::uint64_t, std::unordered_map<std::string, Entry>::iterator>;
+
+    // Only loaded font faces without handles outside the registry are evicted
+    std::vector<Candidate> candidates;
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        const auto & face = it->second.face;
+
+        if (face.wait_for(std::chrono::seconds(0)) == std::future_status::ready && face.get().use_count() == 1)
+        {
+            candidates.emplace_back(it->second.lastAccess, it);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate & lhs, const Candidate & rhs)
+    {
+        return lhs.first < rhs.first;
+    });
+
+    auto numEvicted = std::size_t(0);
+
+    for (const auto & candidate : candidates)
+    {
+        if (m_memoryUsage <= memoryBudget)
+        {
+            break;
+        }
+
+        m_memoryUsage -= candidate.second->second.memoryUsage;
+        m_entries.erase(candidate.second);
+        ++numEvicted;
+    }
+
+    return numEvicted;
+}
+
+std::string FontRegistry::canonicalPath(const std::string & filename)
+{
+#ifdef _WIN32
+    char path[_MAX_PATH];
+    if (_fullpath(path, filename.c_str(), _MAX_PATH))
+    {
+        return path;
+    }
+#else
+    char path[PATH_MAX];
+    if (realpath(filename.c_str(), path))
+    {
+        return path;
+    }
+#endif
+
+    return filename;
+}
+
+
+} // namespace openll
@@ -0,0 +1,113 @@
+
+#include <openll/FontWriter.h>
+
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <vector>
+
+#include <openll/FontFace.h>
+#include <openll/GlyphAtlas.h>
+
+#include "BinaryFont.h"
+
+
+namespace openll
+{
+
+
+bool FontWriter::write(const FontFace & fontFace, const std::string & filename)
+{
+    std::ofstream out(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        return false;
+    }
+
+    return write(fontFace, out);
+}
+
+bool FontWriter::write(const FontFace & fontFace, std::ostream & out)
+{
+    const auto glyphCount = fontFace.m_glyphs.size() - 1;
+    const auto kerningCount = fontFace.m_kerningCount;
+    const auto & atlas = fontFace.glyphAtlas();
+
+    // Kerning runs of all glyphs, including glyphs added after the last kerning
+    auto kerningOffsets = fontFace.m_kerningOffsets;
+    kerningOffsets.resize(glyphCount + 2, static_cast<std::uint32_t>(kerningCount));
+
+    auto header = BinaryFont::Header();
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BinaryFont::magic, sizeof(header.magic));
+
+    header.version       = BinaryFont::version;
+    header.byteOrderMark = BinaryFont::byteOrderMark;
+
+    header.ascent  = fontFace.ascent();
+    header.descent = fontFace.descent();
+    header.linegap = fontFace.linegap();
+    header.glyphTextureExtent[0] = fontFace.glyphTextureExtent().x;
+    header.glyphTextureExtent[1] = fontFace.glyphTextureExtent().y;
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        header.glyphTexturePadding[i] = fontFace.glyphTexturePadding()[i];
+    }
+
+    header.glyphCount     = static_cast<std::uint32_t>(glyphCount);
+    header.kerningCount   = static_cast<std::uint32_t>(kerningCount);
+    header.atlasFormat    = static_cast<std::uint32_t>(atlas.format());
+    header.atlasExtent[0] = atlas.extent().x;
+    header.atlasExtent[1] = atlas.extent().y;
+
+    header.glyphsOffset         = BinaryFont::align(sizeof(header));
+    header.kerningOffsetsOffset = BinaryFont::align(header.glyphsOffset + glyphCount * sizeof(BinaryFont::Glyph));
+    header.kerningIndicesOffset = BinaryFont::align(header.kerningOffsetsOffset + kerningOffsets.size() * sizeof(std::uint32_t));
+    header.kerningAmountsOffset = BinaryFont::align(header.kerningIndicesOffset + kerningCount * sizeof(std::uint32_t));
+    header.atlasOffset          = BinaryFont::align(header.kerningAmountsOffset + kerningCount * sizeof(std::int16_t));
+    header.atlasSize            = atlas.size();
+
+    // Glyph records in order of their dense ids
+    auto glyphs = std::vector<BinaryFont::Glyph>(glyphCount);
+
+    for (auto id = size_t(1); id <= glyphCount; ++id)
+    {
+        const auto & glyph = fontFace.m_glyphs[id];
+        auto & record = glyphs[id - 1];
+
+        record.index               = static_cast<std::uint32_t>(glyph.index());
+        record.advance             = glyph.advance();
+        record.subTextureOrigin[0] = glyph.subTextureOrigin().x;
+        record.subTextureOrigin[1] = glyph.subTextureOrigin().y;
+        record.subTextureExtent[0] = glyph.subTextureExtent().x;
+        record.subTextureExtent[1] = glyph.subTextureExtent().y;
+        record.bearing[0]          = glyph.bearing().x;
+        record.bearing[1]          = glyph.bearing().y;
+        record.extent[0]           = glyph.extent().x;
+        record.extent[1]           = glyph.extent().y;
+    }
+
+    const auto begin = static_cast<std::uint64_t>(out.tellp());
+
+    // Write a section, preceded by zeros up to its offset
+    const auto writeSection = [&out, begin](const std::uint64_t offset, const void * data, const std::size_t size)
+    {
+        static const char zeros[BinaryFont::sectionAlignment] = { };
+
+        out.write(zeros, static_cast<std::streamsize>(begin + offset - static_cast<std::uint64_t>(out.tellp())));
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    };
+
+    writeSection(0, &header, sizeof(header));
+    writeSection(header.glyphsOffset, glyphs.data(), glyphs.size() * sizeof(BinaryFont::Glyph));
+    writeSection(header.kerningOffsetsOffset, kerningOffsets.data(), kerningOffsets.size() * sizeof(std::uint32_t));
+    writeSection(header.kerningIndicesOffset, fontFace.m_kerningIndexData, kerningCount * sizeof(std::uint32_t));
+    writeSection(header.kerningAmountsOffset, fontFace.m_kerningAmountData, kerningCount * sizeof(std::int16_t));
+    writeSection(header.atlasOffset, atlas.data(), atlas.size());
+
+    return static_cast<bool>(out);
+}
+
+
+} // namespace openll
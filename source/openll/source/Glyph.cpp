@@ -12,6 +12,7 @@ Glyph::Glyph(const FontFace * fontFace)
 : m_fontFace(fontFace)
 , m_index(0u)
 , m_advance(0.0f)
+, m_depictable(false)
 {
 }
 
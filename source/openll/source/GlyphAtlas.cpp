@@ -0,0 +1,76 @@
+
+#include <openll/GlyphAtlas.h>
+
+#include <cassert>
+#include <utility>
+
+
+namespace openll
+{
+
+
+GlyphAtlas::GlyphAtlas()
+: m_extent(0, 0)
+, m_format(Format::R8)
+, m_external(nullptr)
+{
+}
+
+GlyphAtlas::GlyphAtlas(const glm::uvec2 & extent, const Format format, std::vector<unsigned char> && pixels)
+: m_extent(extent)
+, m_format(format)
+, m_pixels(std::move(pixels))
+, m_external(nullptr)
+{
+    assert(m_pixels.size() == std::size_t(m_extent.x) * m_extent.y * bytesPerPixel());
+}
+
+GlyphAtlas::GlyphAtlas(const glm::uvec2 & extent, const Format format, const unsigned char * pixels)
+: m_extent(extent)
+, m_format(format)
+, m_external(pixels)
+{
+    assert(pixels != nullptr || m_extent.x * m_extent.y == 0);
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+}
+
+bool GlyphAtlas::empty() const
+{
+    return size() == 0;
+}
+
+bool GlyphAtlas::external() const
+{
+    return m_external != nullptr;
+}
+
+const glm::uvec2 & GlyphAtlas::extent() const
+{
+    return m_extent;
+}
+
+GlyphAtlas::Format GlyphAtlas::format() const
+{
+    return m_format;
+}
+
+std::size_t GlyphAtlas::bytesPerPixel() const
+{
+    return m_format == Format::RGBA8 ? 4 : 1;
+}
+
+const unsigned char * GlyphAtlas::data() const
+{
+    return m_external ? m_external : m_pixels.data();
+}
+
+std::size_t GlyphAtlas::size() const
+{
+    return m_external ? std::size_t(m_extent.x) * m_extent.y * bytesPerPixel() : m_pixels.size();
+}
+
+
+} // namespace openll
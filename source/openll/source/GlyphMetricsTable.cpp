@@ -0,0 +1,89 @@
+
+#include <openll/GlyphMetricsTable.h>
+
+#include <cassert>
+
+#include <openll/Glyph.h>
+
+
+namespace openll
+{
+
+
+GlyphMetricsTable::GlyphMetricsTable()
+{
+}
+
+GlyphMetricsTable::~GlyphMetricsTable()
+{
+}
+
+std::size_t GlyphMetricsTable::size() const
+{
+    return m_advances.size();
+}
+
+void GlyphMetricsTable::resize(const std::size_t size)
+{
+    m_advances.resize(size, 0.0f);
+    m_depictables.resize(size, 0);
+    m_penRectangles.resize(size, glm::vec4(0.0f));
+    m_subtextureRectangles.resize(size, glm::vec4(0.0f));
+    m_indices.resize(size, 0);
+}
+
+bool GlyphMetricsTable::setGlyph(const std::uint32_t id, const Glyph & glyph)
+{
+    assert(id < size());
+
+    if (id >= size())
+    {
+        return false;
+    }
+
+    const auto advance = glyph.advance();
+    const auto depictable = std::uint8_t(glyph.depictable() ? 1 : 0);
+    const auto penRectangle = glm::vec4(glyph.penOrigin(), glyph.penTangent().x, glyph.penBitangent().y);
+    const auto subtextureRectangle = glyph.subtextureRectangle();
+    const auto index = static_cast<std::uint32_t>(glyph.index());
+
+    const auto changed = m_advances[id] != advance || m_depictables[id] != depictable
+        || m_penRectangles[id] != penRectangle || m_subtextureRectangles[id] != subtextureRectangle
+        || m_indices[id] != index;
+
+    m_advances[id] = advance;
+    m_depictables[id] = depictable;
+    m_penRectangles[id] = penRectangle;
+    m_subtextureRectangles[id] = subtextureRectangle;
+    m_indices[id] = index;
+
+    return changed;
+}
+
+const std::vector<float> & GlyphMetricsTable::advances() const
+{
+    return m_advances;
+}
+
+const std::vector<std::uint8_t> & GlyphMetricsTable::depictables() const
+{
+    return m_depictables;
+}
+
+const std::vector<glm::vec4> & GlyphMetricsTable::penRectangles() const
+{
+    return m_penRectangles;
+}
+
+const std::vector<glm::vec4> & GlyphMetricsTable::subtextureRectangles() const
+{
+    return m_subtextureRectangles;
+}
+
+const std::vector<std::uint32_t> & GlyphMetricsTable::indices() const
+{
+    return m_indices;
+}
+
+
+} // namespace openll
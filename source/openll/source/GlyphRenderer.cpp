@@ -1,6 +1,8 @@
 
 #include <openll/GlyphRenderer.h>
 
+#include <cassert>
+
 #include <glm/mat4x4.hpp>
 
 #include <glbinding/gl/gl.h>
@@ -9,10 +11,13 @@
 #include <globjects/Shader.h>
 #include <globjects/Program.h>
 #include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
 
 #include <openll/openll.h>
 #include <openll/GlyphVertexCloud.h>
 
+#include "DrawBatches.h"
+
 
 namespace openll
 {
@@ -78,7 +83,7 @@ void GlyphRenderer::setProgram(std::unique_ptr<globjects::Program> && program)
 void GlyphRenderer::render(const GlyphVertexCloud & vertexCloud) const
 {
     // Abort if vertex array is empty
-    if (vertexCloud.vertices().empty())
+    if (vertexCloud.size() == 0)
     {
         return;
     }
@@ -101,7 +106,7 @@ void GlyphRenderer::render(const GlyphVertexCloud & vertexCloud) const
 void GlyphRenderer::renderInWorld(const GlyphVertexCloud & vertexCloud, const glm::mat4 & viewProjectionMatrix) const
 {
     // Abort if vertex array is empty
-    if (vertexCloud.vertices().empty())
+    if (vertexCloud.size() == 0)
     {
         return;
     }
@@ -121,5 +126,87 @@ void GlyphRenderer::renderInWorld(const GlyphVertexCloud & vertexCloud, const gl
     m_program->release();
 }
 
+GlyphRenderer::Statistics GlyphRenderer::render(const std::vector<const GlyphVertexCloud *> & vertexClouds) const
+{
+    return renderInWorld(vertexClouds, glm::mat4(1.0f));
+}
+
+GlyphRenderer::Statistics GlyphRenderer::renderInWorld(const std::vector<const GlyphVertexCloud *> & vertexClouds, const glm::mat4 & viewProjectionMatrix) const
+{
+    // Skip empty vertex arrays, vertex clouds that have not been uploaded to an arena yet, and vertex clouds without glyph texture
+    auto batches = DrawBatches();
+
+    for (auto index = std::size_t(0); index < vertexClouds.size(); ++index)
+    {
+        const auto vertexCloud = vertexClouds[index];
+
+        assert(vertexCloud != nullptr);
+
+        if (vertexCloud && vertexCloud->size() > 0 && vertexCloud->vao() && vertexCloud->texture())
+        {
+            batches.add(vertexCloud->texture(), vertexCloud->vao(), vertexCloud->arena() != nullptr, index);
+        }
+    }
+
+    // Group vertex clouds by texture and vertex array, so each is bound once
+    batches.build();
+
+    // Abort if all vertex arrays are empty
+    if (batches.entries().empty())
+    {
+        return batches.statistics();
+    }
+
+    // Update uniform values
+    m_program->setUniform("viewProjectionMatrix", viewProjectionMatrix);
+
+    // Bind shader program
+    m_program->use();
+
+    const auto & entries = batches.entries();
+
+    auto firsts = std::vector<gl::GLint>();
+    auto counts = std::vector<gl::GLsizei>();
+
+    for (const auto & batch : batches.batches())
+    {
+        const auto vertexCloud = vertexClouds[entries[batch.begin].index];
+
+        if (batch.bindTexture)
+        {
+            vertexCloud->texture()->bindActive(0);
+        }
+
+        if (batch.end - batch.begin == 1)
+        {
+            // Draw vertex array
+            vertexCloud->draw();
+        }
+        else
+        {
+            // Draw the ranges of all vertex clouds of the arena page by a single call
+            firsts.clear();
+            counts.clear();
+
+            for (auto i = batch.begin; i < batch.end; ++i)
+            {
+                const auto other = vertexClouds[entries[i].index];
+
+                firsts.push_back(static_cast<gl::GLint>(other->allocation().offset));
+                counts.push_back(static_cast<gl::GLsizei>(other->size()));
+            }
+
+            vertexCloud->vao()->bind();
+            gl::glMultiDrawArrays(gl::GL_POINTS, firsts.data(), counts.data(), static_cast<gl::GLsizei>(firsts.size()));
+        }
+    }
+
+    // Release shader program and texture
+    vertexClouds[entries.back().index]->texture()->unbindActive(0);
+    m_program->release();
+
+    return batches.statistics();
+}
+
 
 } // namespace openll
@@ -0,0 +1,166 @@
+
+#include <openll/GlyphVertexArena.h>
+
+#include <cassert>
+#include <limits>
+#include <algorithm>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/VertexArray.h>
+
+#include <openll/GlyphVertexCloud.h>
+
+#include "ArenaAllocator.h"
+
+
+namespace openll
+{
+
+
+const std::size_t GlyphVertexArena::invalidPage = std::numeric_limits<std::size_t>::max();
+
+
+GlyphVertexArena::Page::Page(const std::size_t capacity)
+: buffer(cppassist::make_unique<globjects::Buffer>())
+, vao(cppassist::make_unique<globjects::VertexArray>())
+, allocator(cppassist::make_unique<ArenaAllocator>(capacity))
+{
+    // Ranges of the page are updated independently, possibly on each frame
+    buffer->setData(capacity * sizeof(GlyphVertexCloud::GPUVertex), nullptr, gl::GL_DYNAMIC_DRAW);
+
+    GlyphVertexCloud::setupVertexArray(*vao, *buffer);
+}
+
+GlyphVertexArena::Page::~Page()
+{
+}
+
+bool GlyphVertexArena::Page::empty() const
+{
+    return allocator->available() == allocator->capacity();
+}
+
+
+GlyphVertexArena::GlyphVertexArena(const std::size_t pageCapacity)
+: m_pageCapacity(pageCapacity)
+{
+    assert(pageCapacity > 0);
+}
+
+GlyphVertexArena::~GlyphVertexArena()
+{
+}
+
+GlyphVertexArena::Allocation GlyphVertexArena::allocate(const std::size_t size)
+{
+    if (size == 0)
+    {
+        return { invalidPage, 0, 0 };
+    }
+
+    for (auto page = std::size_t(0); page < m_pages.size(); ++page)
+    {
+        if (!m_pages[page])
+        {
+            continue;
+        }
+
+        const auto offset = m_pages[page]->allocator->allocate(size);
+
+        if (offset != ArenaAllocator::invalidOffset)
+        {
+            return { page, offset, size };
+        }
+    }
+
+    // Reuse the slot of a freed page, so the indices of other pages remain valid
+    const auto freeSlot = std::find(m_pages.begin(), m_pages.end(), nullptr);
+    const auto page = static_cast<std::size_t>(freeSlot - m_pages.begin());
+
+    if (freeSlot == m_pages.end())
+    {
+        m_pages.emplace_back();
+    }
+
+    m_pages[page] = cppassist::make_unique<Page>(std::max(size, m_pageCapacity));
+
+    return { page, m_pages[page]->allocator->allocate(size), size };
+}
+
+void GlyphVertexArena::free(const Allocation & allocation)
+{
+    if (allocation.size == 0)
+    {
+        return;
+    }
+
+    assert(allocation.page < m_pages.size() && m_pages[allocation.page]);
+
+    auto & page = m_pages[allocation.page];
+    page->allocator->free(allocation.offset, allocation.size);
+
+    if (!page->empty())
+    {
+        return;
+    }
+
+    // Keep a single empty page of the regular capacity for reuse, so freeing and allocating again does not recreate it
+    const auto keep = page->allocator->capacity() == m_pageCapacity && std::none_of(m_pages.begin(), m_pages.end(), [&page](const std::unique_ptr<Page> & other)
+    {
+        return other && other != page && other->empty();
+    });
+
+    if (!keep)
+    {
+        page.reset();
+    }
+}
+
+void GlyphVertexArena::trim()
+{
+    for (auto & page : m_pages)
+    {
+        if (page && page->empty())
+        {
+            page.reset();
+        }
+    }
+}
+
+std::size_t GlyphVertexArena::pageCapacity() const
+{
+    return m_pageCapacity;
+}
+
+std::size_t GlyphVertexArena::numPages() const
+{
+    return static_cast<std::size_t>(m_pages.size() - std::count(m_pages.begin(), m_pages.end(), nullptr));
+}
+
+globjects::Buffer * GlyphVertexArena::buffer(const std::size_t page)
+{
+    assert(page < m_pages.size() && m_pages[page]);
+
+    return m_pages[page]->buffer.get();
+}
+
+const globjects::VertexArray * GlyphVertexArena::vao(const std::size_t page) const
+{
+    assert(page < m_pages.size() && m_pages[page]);
+
+    return m_pages[page]->vao.get();
+}
+
+globjects::VertexArray * GlyphVertexArena::vao(const std::size_t page)
+{
+    assert(page < m_pages.size() && m_pages[page]);
+
+    return m_pages[page]->vao.get();
+}
+
+
+} // namespace openll
@@ -1,59 +1,129 @@
 
 #include <openll/GlyphVertexCloud.h>
 
+#include <cassert>
 #include <numeric>
 #include <algorithm>
 
+#include <glm/gtc/packing.hpp>
+
 #include <cppassist/memory/make_unique.h>
 #include <cppassist/memory/offsetof.h>
 
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
 #include <glbinding/gl/boolean.h>
 
 #include <globjects/Texture.h>
 #include <globjects/Buffer.h>
+#include <globjects/Sync.h>
 #include <globjects/VertexArray.h>
 #include <globjects/VertexAttributeBinding.h>
 
+#include <openll/FontFace.h>
+
+#include "DirtyRanges.h"
+#include "StreamSegments.h"
+#include "UpdateFrequency.h"
+
+
+namespace
+{
+
+
+// Number of vertices that are packed at once for upload
+const auto packChunkSize = std::size_t(4096);
+
+// Maximum number of unmodified vertices between modified ranges that are uploaded together
+const auto mergeDistance = std::size_t(64);
+
+// Number of frames with updates within the most recent frames after which the vertex buffer is considered to be updated frequently
+const auto dynamicUpdateCount = std::size_t(8);
+const auto dynamicFrameCount = std::size_t(16);
+
+// Time to wait for the GPU to release a stream segment per attempt (in ns)
+const auto streamWaitTimeout = gl::GLuint64(1000000);
+
+
+} // namespace
+
 
 namespace openll
 {
 
 
+const std::size_t GlyphVertexCloud::numStreamSegments;
+
+
 GlyphVertexCloud::GlyphVertexCloud()
-: m_buffer(cppassist::make_unique<globjects::Buffer>())
+: m_dirtyRanges(cppassist::make_unique<DirtyRanges>(mergeDistance))
+, m_capacity(0)
+, m_uploadedSize(0)
+, m_frequency(cppassist::make_unique<UpdateFrequency>(dynamicUpdateCount, dynamicFrameCount))
+, m_dynamic(false)
+, m_buffer(cppassist::make_unique<globjects::Buffer>())
 , m_vao(cppassist::make_unique<globjects::VertexArray>())
 , m_texture(nullptr)
+, m_fontFace(nullptr)
+, m_streamSegments(cppassist::make_unique<StreamSegments>())
+, m_streamData(nullptr)
+, m_arena(nullptr)
+, m_allocation{ GlyphVertexArena::invalidPage, 0, 0 }
 {
-    // Setup vertex array object
-    m_vao->binding(0)->setAttribute(0);
-    m_vao->binding(0)->setBuffer(m_buffer.get(), 0, sizeof(Vertex));
-    m_vao->binding(0)->setFormat(3, gl::GL_FLOAT, gl::GL_FALSE, cppassist::offset(&Vertex::origin));
-    m_vao->enable(0);
+    setupVertexArray(*m_vao, *m_buffer);
+}
+
+GlyphVertexCloud::GlyphVertexCloud(const std::size_t streamCapacity)
+: GlyphVertexCloud()
+{
+    assert(streamCapacity > 0);
 
-    m_vao->binding(1)->setAttribute(1);
-    m_vao->binding(1)->setBuffer(m_buffer.get(), 0, sizeof(Vertex));
-    m_vao->binding(1)->setFormat(3, gl::GL_FLOAT, gl::GL_FALSE, cppassist::offset(&Vertex::vtan));
-    m_vao->enable(1);
+    m_streamSegments = cppassist::make_unique<StreamSegments>(numStreamSegments, streamCapacity);
 
-    m_vao->binding(2)->setAttribute(2);
-    m_vao->binding(2)->setBuffer(m_buffer.get(), 0, sizeof(Vertex));
-    m_vao->binding(2)->setFormat(3, gl::GL_FLOAT, gl::GL_FALSE, cppassist::offset(&Vertex::vbitan));
-    m_vao->enable(2);
+    // The buffer is mapped once for its lifetime, coherent mapping makes writes visible without explicit flushes
+    const auto size = numStreamSegments * streamCapacity * sizeof(GPUVertex);
 
-    m_vao->binding(3)->setAttribute(3);
-    m_vao->binding(3)->setBuffer(m_buffer.get(), 0, sizeof(Vertex));
-    m_vao->binding(3)->setFormat(4, gl::GL_FLOAT, gl::GL_FALSE, cppassist::offset(&Vertex::uvRect));
-    m_vao->enable(3);
+    m_buffer->setStorage(size, nullptr, gl::GL_MAP_WRITE_BIT | gl::GL_MAP_PERSISTENT_BIT | gl::GL_MAP_COHERENT_BIT);
+    m_streamData = static_cast<GPUVertex *>(m_buffer->mapRange(0, size, gl::GL_MAP_WRITE_BIT | gl::GL_MAP_PERSISTENT_BIT | gl::GL_MAP_COHERENT_BIT));
+}
 
-    m_vao->binding(4)->setAttribute(4);
-    m_vao->binding(4)->setBuffer(m_buffer.get(), 0, sizeof(Vertex));
-    m_vao->binding(4)->setFormat(4, gl::GL_FLOAT, gl::GL_FALSE, cppassist::offset(&Vertex::textColor));
-    m_vao->enable(4);
+GlyphVertexCloud::GlyphVertexCloud(GlyphVertexArena & arena)
+: m_dirtyRanges(cppassist::make_unique<DirtyRanges>(mergeDistance))
+, m_capacity(0)
+, m_uploadedSize(0)
+, m_frequency(cppassist::make_unique<UpdateFrequency>(dynamicUpdateCount, dynamicFrameCount))
+, m_dynamic(false)
+, m_texture(nullptr)
+, m_fontFace(nullptr)
+, m_streamSegments(cppassist::make_unique<StreamSegments>())
+, m_streamData(nullptr)
+, m_arena(&arena)
+, m_allocation{ GlyphVertexArena::invalidPage, 0, 0 }
+{
 }
 
 GlyphVertexCloud::~GlyphVertexCloud()
 {
+    if (m_streamData)
+    {
+        m_buffer->unmap();
+    }
+
+    if (m_arena)
+    {
+        m_arena->free(m_allocation);
+    }
+}
+
+std::size_t GlyphVertexCloud::size() const
+{
+    if (isStreaming())
+    {
+        return m_streamSegments->size();
+    }
+
+    // Vertices that have not been uploaded yet are not drawn
+    return m_arena ? std::min(m_uploadedSize, m_allocation.size) : m_uploadedSize;
 }
 
 const std::vector<GlyphVertexCloud::Vertex> & GlyphVertexCloud::vertices() const
@@ -68,17 +138,42 @@ std::vector<GlyphVertexCloud::Vertex> & GlyphVertexCloud::vertices()
 
 const globjects::VertexArray * GlyphVertexCloud::vao() const
 {
+    if (m_arena)
+    {
+        return m_allocation.size > 0 ? m_arena->vao(m_allocation.page) : nullptr;
+    }
+
     return m_vao.get();
 }
 
 globjects::VertexArray * GlyphVertexCloud::vao()
 {
+    if (m_arena)
+    {
+        return m_allocation.size > 0 ? m_arena->vao(m_allocation.page) : nullptr;
+    }
+
     return m_vao.get();
 }
 
+const GlyphVertexArena * GlyphVertexCloud::arena() const
+{
+    return m_arena;
+}
+
+const GlyphVertexArena::Allocation & GlyphVertexCloud::allocation() const
+{
+    return m_allocation;
+}
+
 const globjects::Texture * GlyphVertexCloud::texture() const
 {
-    return m_texture;
+    if (m_texture || !m_fontFace)
+    {
+        return m_texture;
+    }
+
+    return m_fontFace->glyphTexture();
 }
 
 void GlyphVertexCloud::setTexture(globjects::Texture * texture)
@@ -86,19 +181,291 @@ void GlyphVertexCloud::setTexture(globjects::Texture * texture)
     m_texture = texture;
 }
 
+const FontFace * GlyphVertexCloud::fontFace() const
+{
+    return m_fontFace;
+}
+
+void GlyphVertexCloud::setFontFace(const FontFace * fontFace)
+{
+    m_fontFace = fontFace;
+}
+
+void GlyphVertexCloud::markDirty(const std::size_t first, const std::size_t count)
+{
+    m_dirtyRanges->add(first, first + count);
+}
+
 void GlyphVertexCloud::update()
 {
-    m_buffer->setData(m_vertices, gl::GL_STATIC_DRAW);
+    assert(!isStreaming());
+
+    const auto size = m_vertices.size();
+
+    m_frequency->update();
+
+    // Upload everything if nothing is marked or the buffer lost its contents on reallocation
+    if (reserve(size) || m_dirtyRanges->empty())
+    {
+        upload(m_vertices.data(), size, 0);
+    }
+    else
+    {
+        // Vertices appended since the last update are modified as well
+        m_dirtyRanges->add(m_uploadedSize, size);
+
+        for (const auto & range : m_dirtyRanges->ranges())
+        {
+            // Ranges of removed vertices do not need to be uploaded
+            const auto end = std::min(range.second, size);
+
+            if (range.first < end)
+            {
+                upload(m_vertices.data() + range.first, end - range.first, range.first);
+            }
+        }
+    }
+
+    m_uploadedSize = size;
+    m_dirtyRanges->clear();
 }
 
 void GlyphVertexCloud::update(const std::vector<Vertex> & vertices)
 {
-    m_buffer->setData(vertices, gl::GL_STATIC_DRAW);
+    assert(!isStreaming());
+
+    m_frequency->update();
+
+    reserve(vertices.size());
+    upload(vertices.data(), vertices.size(), 0);
+
+    m_uploadedSize = vertices.size();
+    m_dirtyRanges->clear();
+}
+
+void GlyphVertexCloud::update(const std::size_t first, const std::size_t count)
+{
+    assert(first + count <= m_vertices.size());
+    assert(first + count <= m_uploadedSize);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    upload(m_vertices.data() + first, count, first);
+}
+
+bool GlyphVertexCloud::isStreaming() const
+{
+    return m_streamSegments->capacity() > 0;
+}
+
+std::size_t GlyphVertexCloud::streamCapacity() const
+{
+    return m_streamSegments->capacity();
+}
+
+GlyphVertexCloud::Vertex * GlyphVertexCloud::beginStream()
+{
+    assert(isStreaming());
+
+    const auto segment = m_streamSegments->begin();
+
+    // Wait until the GPU has finished drawing from the segment
+    auto & fence = m_streamFences[segment];
+
+    if (fence)
+    {
+        while (fence->clientWait(gl::GL_SYNC_FLUSH_COMMANDS_BIT, streamWaitTimeout) == gl::GL_TIMEOUT_EXPIRED)
+        {
+        }
+
+        fence.reset();
+    }
+
+#ifdef OPENLL_COMPACT_VERTICES
+    // Vertices are packed into the segment on endStream()
+    m_vertices.resize(m_streamSegments->capacity());
+
+    return m_vertices.data();
+#else
+    return m_streamData + m_streamSegments->offset();
+#endif
+}
+
+void GlyphVertexCloud::endStream(const std::size_t count)
+{
+    assert(isStreaming());
+
+    m_streamSegments->end(count);
+
+#ifdef OPENLL_COMPACT_VERTICES
+    pack(m_vertices.data(), m_streamSegments->size(), m_streamData + m_streamSegments->offset());
+#endif
+}
+
+void GlyphVertexCloud::pack(const Vertex * vertices, const std::size_t count, PackedVertex * packed)
+{
+    for (auto i = std::size_t(0); i < count; ++i)
+    {
+        const auto & vertex = vertices[i];
+        auto & target = packed[i];
+
+        target.origin = vertex.origin;
+
+        for (auto c = 0; c < 3; ++c)
+        {
+            target.vtan[c]   = glm::packHalf1x16(vertex.vtan[c]);
+            target.vbitan[c] = glm::packHalf1x16(vertex.vbitan[c]);
+        }
+
+        target.vtan[3]   = 0;
+        target.vbitan[3] = 0;
+
+        for (auto c = 0; c < 4; ++c)
+        {
+            target.uvRect[c]    = glm::packUnorm1x16(vertex.uvRect[c]);
+            target.textColor[c] = glm::packUnorm1x8(vertex.textColor[c]);
+        }
+    }
+}
+
+bool GlyphVertexCloud::reserve(const std::size_t size)
+{
+    // A static buffer that turns out to be updated frequently is reallocated once with a dynamic usage hint
+    const auto becomesDynamic = !m_arena && !m_dynamic && m_capacity > 0 && m_frequency->isFrequent();
+
+    if (size > m_capacity)
+    {
+        m_capacity = std::max(size, 2 * m_capacity);
+    }
+    else if (!becomesDynamic)
+    {
+        return false;
+    }
+
+    // Move to a larger range of the arena, the previous range may be reused by other vertex clouds.
+    // The previous range is freed afterwards, so its page is not deleted if the new range fits into it.
+    if (m_arena)
+    {
+        const auto previous = m_allocation;
+
+        m_allocation = m_arena->allocate(m_capacity);
+        m_arena->free(previous);
+
+        return true;
+    }
+
+    // Vertex lists that are updated frequently are likely to change on each frame
+    m_dynamic = m_dynamic || m_frequency->isFrequent();
+
+    const auto usage = m_dynamic ? gl::GL_DYNAMIC_DRAW : gl::GL_STATIC_DRAW;
+
+    m_buffer->setData(m_capacity * sizeof(GPUVertex), nullptr, usage);
+
+    return true;
+}
+
+void GlyphVertexCloud::upload(const Vertex * vertices, const std::size_t count, const std::size_t first)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    assert(first + count <= m_capacity);
+
+    // Vertices of an arena are stored in the allocated range of a shared buffer
+    const auto buffer = m_arena ? m_arena->buffer(m_allocation.page) : m_buffer.get();
+    const auto base = m_arena ? m_allocation.offset + first : first;
+
+#ifdef OPENLL_COMPACT_VERTICES
+    // Pack in chunks, so the packed copy stays small
+    m_packed.resize(std::min(count, packChunkSize));
+
+    for (auto offset = std::size_t(0); offset < count; offset += packChunkSize)
+    {
+        const auto chunkSize = std::min(count - offset, packChunkSize);
+
+        pack(vertices + offset, chunkSize, m_packed.data());
+        buffer->setSubData((base + offset) * sizeof(PackedVertex), chunkSize * sizeof(PackedVertex), m_packed.data());
+    }
+#else
+    buffer->setSubData(base * sizeof(Vertex), count * sizeof(Vertex), vertices);
+#endif
 }
 
 void GlyphVertexCloud::draw() const
 {
-    m_vao->drawArrays(gl::GL_POINTS, 0, m_vertices.size());
+    m_frequency->draw();
+
+    if (m_arena)
+    {
+        if (size() == 0)
+        {
+            return;
+        }
+
+        // The vertex array is shared with the other vertex clouds of the page
+        m_arena->vao(m_allocation.page)->drawArrays(gl::GL_POINTS, static_cast<gl::GLint>(m_allocation.offset), static_cast<gl::GLsizei>(size()));
+
+        return;
+    }
+
+    if (!isStreaming())
+    {
+        m_vao->drawArrays(gl::GL_POINTS, 0, static_cast<gl::GLsizei>(size()));
+
+        return;
+    }
+
+    m_vao->drawArrays(gl::GL_POINTS, static_cast<gl::GLint>(m_streamSegments->offset()), static_cast<gl::GLsizei>(m_streamSegments->size()));
+
+    // The segment must not be overwritten until the GPU has finished drawing it
+    m_streamFences[m_streamSegments->segment()] = globjects::Sync::fence(gl::GL_SYNC_GPU_COMMANDS_COMPLETE);
+}
+
+void GlyphVertexCloud::setupVertexArray(globjects::VertexArray & vao, globjects::Buffer & buffer)
+{
+    // Attribute types of the GPU vertex format, converted to floats for the vertex shader
+#ifdef OPENLL_COMPACT_VERTICES
+    const auto tangentType = gl::GL_HALF_FLOAT;
+    const auto uvRectType  = gl::GL_UNSIGNED_SHORT;
+    const auto colorType   = gl::GL_UNSIGNED_BYTE;
+    const auto normalized  = gl::GL_TRUE;
+#else
+    const auto tangentType = gl::GL_FLOAT;
+    const auto uvRectType  = gl::GL_FLOAT;
+    const auto colorType   = gl::GL_FLOAT;
+    const auto normalized  = gl::GL_FALSE;
+#endif
+
+    // Setup vertex array object
+    vao.binding(0)->setAttribute(0);
+    vao.binding(0)->setBuffer(&buffer, 0, sizeof(GPUVertex));
+    vao.binding(0)->setFormat(3, gl::GL_FLOAT, gl::GL_FALSE, cppassist::offset(&GPUVertex::origin));
+    vao.enable(0);
+
+    vao.binding(1)->setAttribute(1);
+    vao.binding(1)->setBuffer(&buffer, 0, sizeof(GPUVertex));
+    vao.binding(1)->setFormat(3, tangentType, gl::GL_FALSE, cppassist::offset(&GPUVertex::vtan));
+    vao.enable(1);
+
+    vao.binding(2)->setAttribute(2);
+    vao.binding(2)->setBuffer(&buffer, 0, sizeof(GPUVertex));
+    vao.binding(2)->setFormat(3, tangentType, gl::GL_FALSE, cppassist::offset(&GPUVertex::vbitan));
+    vao.enable(2);
+
+    vao.binding(3)->setAttribute(3);
+    vao.binding(3)->setBuffer(&buffer, 0, sizeof(GPUVertex));
+    vao.binding(3)->setFormat(4, uvRectType, normalized, cppassist::offset(&GPUVertex::uvRect));
+    vao.enable(3);
+
+    vao.binding(4)->setAttribute(4);
+    vao.binding(4)->setBuffer(&buffer, 0, sizeof(GPUVertex));
+    vao.binding(4)->setFormat(4, colorType, normalized, cppassist::offset(&GPUVertex::textColor));
+    vao.enable(4);
 }
 
 
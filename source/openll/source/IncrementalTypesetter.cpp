@@ -0,0 +1,237 @@
+
+#include <openll/IncrementalTypesetter.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <glm/common.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/Label.h>
+#include <openll/Typesetter.h>
+
+
+namespace openll
+{
+
+
+IncrementalTypesetter::IncrementalTypesetter(GlyphVertexCloud & vertexCloud)
+: m_vertexCloud(&vertexCloud)
+, m_vertices(vertexCloud.vertices())
+, m_numUnused(0)
+, m_numChanged(0)
+{
+    // Streaming vertex clouds are rewritten on each frame, so there is nothing to keep
+    assert(!vertexCloud.isStreaming());
+
+    m_vertices.clear();
+}
+
+IncrementalTypesetter::IncrementalTypesetter(std::vector<GlyphVertexCloud::Vertex> & vertices)
+: m_vertexCloud(nullptr)
+, m_vertices(vertices)
+, m_numUnused(0)
+, m_numChanged(0)
+{
+    m_vertices.clear();
+}
+
+IncrementalTypesetter::~IncrementalTypesetter()
+{
+}
+
+glm::vec2 IncrementalTypesetter::typeset(const std::vector<Label> & labels)
+{
+    auto & vertices = m_vertices;
+
+    m_dirtyRanges.clear();
+    m_numChanged = 0;
+
+    // Release slots of removed labels
+    for (auto i = labels.size(); i < m_slots.size(); ++i)
+    {
+        const auto & position = m_positions[i];
+
+        clearVertices(position.first, position.second);
+        m_dirtyRanges.emplace_back(position.first, position.second);
+        m_numUnused += position.second - position.first;
+    }
+
+    // Add empty slots for new labels (generations start at 1, so they are typeset below)
+    m_slots.resize(labels.size());
+    m_positions.resize(labels.size(), std::make_pair(std::uint32_t(0), std::uint32_t(0)));
+
+    const FontFace * fontFace = nullptr;
+
+    auto extent = glm::vec2(0.0f, 0.0f);
+    for (size_t i = 0; i < labels.size(); ++i)
+    {
+        const auto & label = labels[i];
+
+        auto & slot = m_slots[i];
+        auto & position = m_positions[i];
+
+        // Check that the same font face is used for all labels
+        assert(fontFace == nullptr || label.fontFace() == nullptr || label.fontFace() == fontFace);
+
+        // Remember font face from first label
+        if (!fontFace)
+        {
+            fontFace = label.fontFace();
+        }
+
+        // Skip unchanged labels
+        const auto layoutValid = slot.layout.isValid(label);
+
+        if (slot.generation == label.generation() && layoutValid)
+        {
+            extent = glm::max(extent, slot.extent);
+            continue;
+        }
+
+        ++m_numChanged;
+
+        slot.generation = label.generation();
+
+        // Re-layout label only if its text or layout properties have changed
+        if (!layoutValid)
+        {
+            Typesetter::layout(slot.layout, label);
+        }
+
+        // Transform layout into scratch vertices
+        m_scratch.assign(slot.layout.vertices().cbegin(), slot.layout.vertices().cend());
+        Typesetter::vertex_transform(label.transform(), label.textColor(), m_scratch.data(), 0, m_scratch.size());
+
+        slot.extent = label.fontFace() && label.text() ? Typesetter::extent_transform(label, slot.layout.extent()) : glm::vec2(0.0f, 0.0f);
+
+        extent = glm::max(extent, slot.extent);
+
+        const auto count = std::uint32_t(m_scratch.size());
+        const auto previousCount = position.second - position.first;
+
+        if (count <= slot.capacity)
+        {
+            // Typeset into existing slot and clear the remaining vertices of the previous layout
+            std::copy(m_scratch.cbegin(), m_scratch.cend(), vertices.begin() + position.first);
+
+            if (count < previousCount)
+            {
+                clearVertices(position.first + count, position.second);
+            }
+
+            m_dirtyRanges.emplace_back(position.first, position.first + std::max(count, previousCount));
+            m_numUnused = m_numUnused + previousCount - count;
+        }
+        else
+        {
+            // Move label to a new slot at the end of the vertex cloud
+            clearVertices(position.first, position.second);
+            m_dirtyRanges.emplace_back(position.first, position.second);
+            m_numUnused += previousCount;
+
+            position.first = std::uint32_t(vertices.size());
+            slot.capacity = count;
+
+            vertices.insert(vertices.end(), m_scratch.cbegin(), m_scratch.cend());
+        }
+
+        position.second = position.first + count;
+    }
+
+    // Remove unused vertices if they make up more than half of the vertex cloud
+    const auto compacted = m_numUnused > vertices.size() / 2;
+
+    if (compacted)
+    {
+        compact();
+    }
+
+    if (!m_vertexCloud)
+    {
+        return extent;
+    }
+
+    if (compacted)
+    {
+        // Upload the entire vertex cloud
+        m_vertexCloud->update();
+    }
+    else if (!m_dirtyRanges.empty())
+    {
+        // Upload modified ranges only, the vertex cloud merges them
+        for (const auto & dirty : m_dirtyRanges)
+        {
+            m_vertexCloud->markDirty(dirty.first, dirty.second - dirty.first);
+        }
+
+        m_vertexCloud->update();
+    }
+
+    // Set font face, whose glyph texture is resolved when rendering
+    if (fontFace != nullptr)
+    {
+        m_vertexCloud->setFontFace(fontFace);
+    }
+
+    return extent;
+}
+
+const std::vector<std::pair<std::uint32_t, std::uint32_t>> & IncrementalTypesetter::positions() const
+{
+    return m_positions;
+}
+
+std::size_t IncrementalTypesetter::numChangedLabels() const
+{
+    return m_numChanged;
+}
+
+void IncrementalTypesetter::clear()
+{
+    m_slots.clear();
+    m_positions.clear();
+    m_numUnused = 0;
+    m_numChanged = 0;
+
+    m_vertices.clear();
+
+    if (m_vertexCloud)
+    {
+        m_vertexCloud->update();
+    }
+}
+
+void IncrementalTypesetter::clearVertices(const std::size_t begin, const std::size_t end)
+{
+    auto & vertices = m_vertices;
+
+    // Vertices with empty extent and transparent color do not produce any fragments
+    std::fill(vertices.begin() + begin, vertices.begin() + end, GlyphVertexCloud::Vertex());
+}
+
+void IncrementalTypesetter::compact()
+{
+    auto & vertices = m_vertices;
+
+    auto compacted = std::vector<GlyphVertexCloud::Vertex>();
+    compacted.reserve(vertices.size() - m_numUnused);
+
+    for (size_t i = 0; i < m_slots.size(); ++i)
+    {
+        auto & position = m_positions[i];
+        const auto count = position.second - position.first;
+
+        const auto first = std::uint32_t(compacted.size());
+        compacted.insert(compacted.end(), vertices.cbegin() + position.first, vertices.cbegin() + position.second);
+
+        position = std::make_pair(first, first + count);
+        m_slots[i].capacity = count;
+    }
+
+    std::swap(vertices, compacted);
+    m_numUnused = 0;
+}
+
+
+} // namespace openll
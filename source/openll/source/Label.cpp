@@ -1,6 +1,8 @@
 
 #include <openll/Label.h>
 
+#include <atomic>
+
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
@@ -9,6 +11,22 @@
 
 #include <openll/Text.h>
 #include <openll/FontFace.h>
+#include <openll/LineBreakTable.h>
+
+
+namespace
+{
+
+
+std::uint64_t nextGeneration()
+{
+    static std::atomic<std::uint64_t> generation(0);
+
+    return ++generation;
+}
+
+
+} // namespace
 
 
 namespace openll
@@ -20,9 +38,12 @@ Label::Label()
 , m_fontSize(16)
 , m_wordWrap(false)
 , m_lineWidth(0.0f)
+, m_lineBreakTable(&LineBreakTable::defaultTable())
 , m_alignment(Alignment::LeftAligned)
 , m_anchor(LineAnchor::Baseline)
 , m_textColor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f))
+, m_generation(nextGeneration())
+, m_layoutGeneration(m_generation)
 {
 }
 
@@ -38,18 +59,21 @@ const std::shared_ptr<Text> & Label::text() const
 void Label::setText(const std::shared_ptr<Text> & text)
 {
     m_text = text;
+    updateGeneration(true);
 }
 
 void Label::setText(const std::u32string & text)
 {
     m_text = std::shared_ptr<Text>(new Text);
     m_text->setText(text);
+    updateGeneration(true);
 }
 
 void Label::setText(std::u32string && text)
 {
     m_text = std::shared_ptr<Text>(new Text);
     m_text->setText(std::move(text));
+    updateGeneration(true);
 }
 
 const FontFace * Label::fontFace() const
@@ -60,6 +84,7 @@ const FontFace * Label::fontFace() const
 void Label::setFontFace(FontFace & fontFace)
 {
     m_fontFace = &fontFace;
+    updateGeneration(true);
 }
 
 float Label::fontSize() const
@@ -70,6 +95,7 @@ float Label::fontSize() const
 void Label::setFontSize(float fontSize)
 {
     m_fontSize = fontSize;
+    updateGeneration(true);
 }
 
 bool Label::wordWrap() const
@@ -80,6 +106,7 @@ bool Label::wordWrap() const
 void Label::setWordWrap(bool wrap)
 {
     m_wordWrap = wrap;
+    updateGeneration(true);
 }
 
 float Label::lineWidth() const
@@ -90,6 +117,18 @@ float Label::lineWidth() const
 void Label::setLineWidth(float lineWidth)
 {
     m_lineWidth = lineWidth;
+    updateGeneration(true);
+}
+
+const LineBreakTable & Label::lineBreakTable() const
+{
+    return *m_lineBreakTable;
+}
+
+void Label::setLineBreakTable(const LineBreakTable & lineBreakTable)
+{
+    m_lineBreakTable = &lineBreakTable;
+    updateGeneration(true);
 }
 
 const glm::vec4 & Label::margins() const
@@ -100,6 +139,7 @@ const glm::vec4 & Label::margins() const
 void Label::setMargins(const glm::vec4 & margins)
 {
     m_margins = margins;
+    updateGeneration(false);
 }
 
 Alignment Label::alignment() const
@@ -110,6 +150,7 @@ Alignment Label::alignment() const
 void Label::setAlignment(Alignment alignment)
 {
     m_alignment = alignment;
+    updateGeneration(true);
 }
 
 LineAnchor Label::lineAnchor() const
@@ -120,6 +161,7 @@ LineAnchor Label::lineAnchor() const
 void Label::setLineAnchor(LineAnchor anchor)
 {
     m_anchor = anchor;
+    updateGeneration(true);
 }
 
 float Label::lineAnchorOffset() const
@@ -152,6 +194,7 @@ const glm::vec4 & Label::textColor() const
 void Label::setTextColor(const glm::vec4 & color)
 {
     m_textColor = color;
+    updateGeneration(false);
 }
 
 const glm::mat4 & Label::transform() const
@@ -162,6 +205,7 @@ const glm::mat4 & Label::transform() const
 void Label::setTransform(const glm::mat4 & transform)
 {
     m_transform = transform;
+    updateGeneration(false);
 }
 
 void Label::setTransform2D(const glm::vec2 & origin, const glm::uvec2 & viewportExtent, float pixelPerInch)
@@ -196,6 +240,8 @@ void Label::setTransform2D(const glm::vec2 & origin, const glm::uvec2 & viewport
 
     // Scale glyphs of font face to target font size
     m_transform = glm::scale(m_transform, glm::vec3(glm::vec2(m_fontSize / m_fontFace->size()), 1.0f));
+
+    updateGeneration(false);
 }
 
 void Label::setTransform3D(const glm::vec3 & origin, const glm::mat4 & transform)
@@ -211,6 +257,28 @@ void Label::setTransform3D(const glm::vec3 & origin, const glm::mat4 & transform
 
     // Apply transform
     m_transform = m_transform * transform;
+
+    updateGeneration(false);
+}
+
+std::uint64_t Label::generation() const
+{
+    return m_generation;
+}
+
+std::uint64_t Label::layoutGeneration() const
+{
+    return m_layoutGeneration;
+}
+
+void Label::updateGeneration(const bool layout)
+{
+    m_generation = nextGeneration();
+
+    if (layout)
+    {
+        m_layoutGeneration = m_generation;
+    }
 }
 
 
@@ -0,0 +1,55 @@
+
+#include <openll/LabelLayout.h>
+
+#include <openll/FontFace.h>
+#include <openll/Label.h>
+#include <openll/LineBreakTable.h>
+#include <openll/Text.h>
+
+
+namespace openll
+{
+
+
+LabelLayout::LabelLayout()
+: m_extent(0.0f, 0.0f)
+, m_layoutGeneration(0)
+, m_text(nullptr)
+, m_textGeneration(0)
+, m_fontFaceGeneration(0)
+, m_lineBreakTableGeneration(0)
+{
+}
+
+LabelLayout::~LabelLayout()
+{
+}
+
+bool LabelLayout::isValid(const Label & label) const
+{
+    // Generations start at 1, so an empty layout is never valid.
+    // Font face and line break table are the ones of the label, as replacing them changes its layout generation.
+    return m_layoutGeneration == label.layoutGeneration()
+        && m_text == label.text().get()
+        && (m_text == nullptr || m_textGeneration == m_text->generation())
+        && (label.fontFace() == nullptr || m_fontFaceGeneration == label.fontFace()->generation())
+        && m_lineBreakTableGeneration == label.lineBreakTable().generation();
+}
+
+const std::vector<GlyphVertexCloud::Vertex> & LabelLayout::vertices() const
+{
+    return m_vertices;
+}
+
+const std::vector<glm::vec2> & LabelLayout::lineExtents() const
+{
+    return m_lineExtents;
+}
+
+const glm::vec2 & LabelLayout::extent() const
+{
+    return m_extent;
+}
+
+
+} // namespace openll
@@ -0,0 +1,325 @@
+
+#include <openll/LineBreakTable.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+
+
+namespace
+{
+
+
+using openll::LineBreakClass;
+using Block = openll::LineBreakTable::Block;
+
+
+std::uint64_t nextGeneration()
+{
+    static std::atomic<std::uint64_t> generation(0);
+
+    return ++generation;
+}
+
+
+// Default classes of the basic multilingual plane (sorted, not overlapping).
+// The delimiters of previous versions ( , . / ( ) [ ] < > ) are kept as break opportunities.
+
+struct Range
+{
+    char32_t       first;
+    char32_t       last;
+    LineBreakClass lineBreakClass;
+};
+
+constexpr Range ranges[] = {
+    { 0x0009, 0x0009, LineBreakClass::Space       }, // Character tabulation
+    { 0x0020, 0x0020, LineBreakClass::Space       }, // Space
+    { 0x0028, 0x0029, LineBreakClass::BreakAfter  }, // ( )
+    { 0x002C, 0x002C, LineBreakClass::BreakAfter  }, // ,
+    { 0x002D, 0x002D, LineBreakClass::Hyphen      }, // Hyphen-minus
+    { 0x002E, 0x002F, LineBreakClass::BreakAfter  }, // . /
+    { 0x003C, 0x003C, LineBreakClass::BreakAfter  }, // <
+    { 0x003E, 0x003E, LineBreakClass::BreakAfter  }, // >
+    { 0x005B, 0x005B, LineBreakClass::BreakAfter  }, // [
+    { 0x005D, 0x005D, LineBreakClass::BreakAfter  }, // ]
+    { 0x00A0, 0x00A0, LineBreakClass::NoBreak     }, // No-break space
+    { 0x00AD, 0x00AD, LineBreakClass::Hyphen      }, // Soft hyphen
+    { 0x1680, 0x1680, LineBreakClass::Space       }, // Ogham space mark
+    { 0x2000, 0x2006, LineBreakClass::Space       }, // En quad to six-per-em space
+    { 0x2007, 0x2007, LineBreakClass::NoBreak     }, // Figure space
+    { 0x2008, 0x200B, LineBreakClass::Space       }, // Punctuation space to zero width space
+    { 0x2010, 0x2010, LineBreakClass::Hyphen      }, // Hyphen
+    { 0x2011, 0x2011, LineBreakClass::NoBreak     }, // Non-breaking hyphen
+    { 0x2012, 0x2013, LineBreakClass::Hyphen      }, // Figure dash, en dash
+    { 0x202F, 0x202F, LineBreakClass::NoBreak     }, // Narrow no-break space
+    { 0x205F, 0x205F, LineBreakClass::Space       }, // Medium mathematical space
+    { 0x2060, 0x2060, LineBreakClass::NoBreak     }, // Word joiner
+    { 0x2E80, 0x2FFF, LineBreakClass::Ideographic }, // CJK radicals, Kangxi radicals, ideographic description
+    { 0x3000, 0x3000, LineBreakClass::Space       }, // Ideographic space
+    { 0x3001, 0x3002, LineBreakClass::BreakAfter  }, // Ideographic comma and full stop
+    { 0x3003, 0x4DBF, LineBreakClass::Ideographic }, // CJK symbols, kana, bopomofo, CJK extension A
+    { 0x4E00, 0xA4CF, LineBreakClass::Ideographic }, // CJK unified ideographs, Yi
+    { 0xAC00, 0xD7A3, LineBreakClass::Ideographic }, // Hangul syllables
+    { 0xF900, 0xFAFF, LineBreakClass::Ideographic }, // CJK compatibility ideographs
+    { 0xFE30, 0xFE4F, LineBreakClass::Ideographic }, // CJK compatibility forms
+    { 0xFEFF, 0xFEFF, LineBreakClass::NoBreak     }, // Zero width no-break space
+    { 0xFF01, 0xFF0B, LineBreakClass::Ideographic }, // Fullwidth forms
+    { 0xFF0C, 0xFF0C, LineBreakClass::BreakAfter  }, // Fullwidth comma
+    { 0xFF0D, 0xFF0D, LineBreakClass::Ideographic }, // Fullwidth hyphen-minus
+    { 0xFF0E, 0xFF0E, LineBreakClass::BreakAfter  }, // Fullwidth full stop
+    { 0xFF0F, 0xFF60, LineBreakClass::Ideographic }, // Fullwidth forms
+    { 0xFF61, 0xFF61, LineBreakClass::BreakAfter  }, // Halfwidth ideographic full stop
+    { 0xFF62, 0xFF9F, LineBreakClass::Ideographic }, // Halfwidth katakana
+    { 0xFFE0, 0xFFE6, LineBreakClass::Ideographic }  // Fullwidth signs
+};
+
+constexpr auto rangeCount = sizeof(ranges) / sizeof(ranges[0]);
+
+constexpr LineBreakClass classify(const char32_t character, const std::size_t range = 0)
+{
+    return range == rangeCount || character < ranges[range].first ? LineBreakClass::Other
+        : character <= ranges[range].last ? ranges[range].lineBreakClass
+        : classify(character, range + 1);
+}
+
+
+// Blocks 0 and 1 are shared by all blocks with uniform classes, followed by
+// one block for each upper byte whose characters are of different classes.
+// Note: mixedBlocks has to list each upper byte at which a range above begins
+// or ends within a block.
+
+constexpr std::uint16_t otherBlock       = 0;
+constexpr std::uint16_t ideographicBlock = 1;
+
+constexpr char32_t mixedBlocks[] = { 0x00, 0x16, 0x20, 0x2E, 0x30, 0x4D, 0xA4, 0xD7, 0xFE, 0xFF };
+
+constexpr auto mixedBlockCount = sizeof(mixedBlocks) / sizeof(mixedBlocks[0]);
+
+constexpr std::uint16_t blockIndex(const char32_t upper, const std::size_t mixed = 0)
+{
+    return mixed == mixedBlockCount
+            ? (classify(upper << 8) == LineBreakClass::Ideographic ? ideographicBlock : otherBlock)
+        : mixedBlocks[mixed] == upper ? static_cast<std::uint16_t>(2 + mixed)
+        : blockIndex(upper, mixed + 1);
+}
+
+
+// Compile-time index sequences (std::index_sequence is C++14), built in logarithmic depth
+
+template <std::size_t... I>
+struct Indices
+{
+};
+
+template <typename Lower, typename Upper>
+struct ConcatIndices;
+
+template <std::size_t... L, std::size_t... U>
+struct ConcatIndices<Indices<L...>, Indices<U...>>
+{
+    using type = Indices<L..., (sizeof...(L) + U)...>;
+};
+
+template <std::size_t N>
+struct MakeIndices
+{
+    using type = typename ConcatIndices<typename MakeIndices<N / 2>::type, typename MakeIndices<N - N / 2>::type>::type;
+};
+
+template <>
+struct MakeIndices<0>
+{
+    using type = Indices<>;
+};
+
+template <>
+struct MakeIndices<1>
+{
+    using type = Indices<0>;
+};
+
+using ByteIndices = MakeIndices<256>::type;
+
+
+struct Stage1
+{
+    std::uint16_t blocks[256];
+};
+
+template <std::size_t... I>
+constexpr Stage1 makeStage1(Indices<I...>)
+{
+    return Stage1{ { blockIndex(static_cast<char32_t>(I))... } };
+}
+
+template <std::size_t... I>
+constexpr Block makeBlock(const char32_t base, Indices<I...>)
+{
+    return Block{ { classify(base + static_cast<char32_t>(I))... } };
+}
+
+template <std::size_t... I>
+constexpr Block makeUniformBlock(const LineBreakClass lineBreakClass, Indices<I...>)
+{
+    return Block{ { (static_cast<void>(I), lineBreakClass)... } };
+}
+
+template <std::size_t... M>
+struct DefaultTable
+{
+    static constexpr Stage1 stage1 = makeStage1(ByteIndices());
+
+    static constexpr Block blocks[] = {
+        makeUniformBlock(LineBreakClass::Other, ByteIndices())
+    ,   makeUniformBlock(LineBreakClass::Ideographic, ByteIndices())
+    ,   makeBlock(mixedBlocks[M] << 8, ByteIndices())...
+    };
+};
+
+template <std::size_t... M>
+constexpr Stage1 DefaultTable<M...>::stage1;
+
+template <std::size_t... M>
+constexpr Block DefaultTable<M...>::blocks[];
+
+template <std::size_t... M>
+DefaultTable<M...> defaultTable(Indices<M...>);
+
+using Default = decltype(defaultTable(MakeIndices<mixedBlockCount>::type()));
+
+
+LineBreakClass supplementaryClass(const char32_t character)
+{
+    // Pictographs and emoji, CJK extensions B and later
+    return (character >= 0x1F000 && character <= 0x1FAFF) || (character >= 0x20000 && character <= 0x3FFFF)
+        ? LineBreakClass::Ideographic : LineBreakClass::Other;
+}
+
+
+} // namespace
+
+
+namespace openll
+{
+
+
+const LineBreakTable & LineBreakTable::defaultTable()
+{
+    static const LineBreakTable table;
+
+    return table;
+}
+
+bool LineBreakTable::isBreakOpportunity(const LineBreakClass before, const LineBreakClass after)
+{
+    // Never break before spaces and punctuation or around no-break characters
+    if (before == LineBreakClass::NoBreak || after == LineBreakClass::NoBreak
+        || after == LineBreakClass::Space || after == LineBreakClass::Hyphen || after == LineBreakClass::BreakAfter)
+    {
+        return false;
+    }
+
+    return before != LineBreakClass::Other || after == LineBreakClass::Ideographic;
+}
+
+LineBreakTable::LineBreakTable()
+: m_stage1(Default::stage1.blocks)
+, m_blocks(Default::blocks)
+, m_generation(nextGeneration())
+{
+}
+
+LineBreakTable::LineBreakTable(const LineBreakTable & other)
+: m_stage1(Default::stage1.blocks)
+, m_blocks(Default::blocks)
+, m_ownStage1(other.m_ownStage1)
+, m_ownBlocks(other.m_ownBlocks)
+, m_generation(nextGeneration())
+{
+    if (!m_ownStage1.empty())
+    {
+        m_stage1 = m_ownStage1.data();
+        m_blocks = m_ownBlocks.data();
+    }
+}
+
+LineBreakTable::~LineBreakTable()
+{
+}
+
+LineBreakTable & LineBreakTable::operator=(const LineBreakTable & other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    m_ownStage1 = other.m_ownStage1;
+    m_ownBlocks = other.m_ownBlocks;
+
+    m_stage1 = m_ownStage1.empty() ? Default::stage1.blocks : m_ownStage1.data();
+    m_blocks = m_ownBlocks.empty() ? Default::blocks : m_ownBlocks.data();
+
+    m_generation = nextGeneration();
+
+    return *this;
+}
+
+LineBreakClass LineBreakTable::lineBreakClass(const char32_t character) const
+{
+    if (character > 0xFFFF)
+    {
+        return supplementaryClass(character);
+    }
+
+    return m_blocks[m_stage1[character >> 8]].classes[character & 0xFF];
+}
+
+void LineBreakTable::setLineBreakClass(const char32_t character, const LineBreakClass lineBreakClass)
+{
+    assert(character <= 0xFFFF);
+
+    if (character > 0xFFFF)
+    {
+        return;
+    }
+
+    detach();
+
+    // Blocks shared between upper bytes are copied before modification
+    auto & index = m_ownStage1[character >> 8];
+
+    if (std::count(m_ownStage1.cbegin(), m_ownStage1.cend(), index) > 1)
+    {
+        m_ownBlocks.push_back(m_ownBlocks[index]);
+        index = static_cast<std::uint16_t>(m_ownBlocks.size() - 1);
+    }
+
+    m_ownBlocks[index].classes[character & 0xFF] = lineBreakClass;
+
+    m_stage1 = m_ownStage1.data();
+    m_blocks = m_ownBlocks.data();
+
+    m_generation = nextGeneration();
+}
+
+std::uint64_t LineBreakTable::generation() const
+{
+    return m_generation;
+}
+
+void LineBreakTable::detach()
+{
+    if (!m_ownStage1.empty())
+    {
+        return;
+    }
+
+    m_ownStage1.assign(m_stage1, m_stage1 + 256);
+    m_ownBlocks.assign(m_blocks, m_blocks + sizeof(Default::blocks) / sizeof(Default::blocks[0]));
+}
+
+
+} // namespace openll
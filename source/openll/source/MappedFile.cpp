@@ -0,0 +1,117 @@
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace openll
+{
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string & filename)
+: m_data(nullptr)
+, m_size(0)
+, m_handle(nullptr)
+{
+    const auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    auto size = LARGE_INTEGER();
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        m_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+
+    // The mapping keeps the file open
+    CloseHandle(file);
+
+    if (!m_handle)
+    {
+        return;
+    }
+
+    m_data = static_cast<const unsigned char *>(MapViewOfFile(m_handle, FILE_MAP_READ, 0, 0, 0));
+    m_size = m_data ? static_cast<std::size_t>(size.QuadPart) : 0;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_handle)
+    {
+        CloseHandle(m_handle);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string & filename)
+: m_data(nullptr)
+, m_size(0)
+, m_handle(nullptr)
+{
+    const auto file = open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        const auto data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (data != MAP_FAILED)
+        {
+            m_data = static_cast<const unsigned char *>(data);
+            m_size = static_cast<std::size_t>(status.st_size);
+        }
+    }
+
+    // The mapping keeps the file open
+    close(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        munmap(const_cast<unsigned char *>(m_data), m_size);
+    }
+}
+
+#endif
+
+bool MappedFile::isValid() const
+{
+    return m_data != nullptr;
+}
+
+const unsigned char * MappedFile::data() const
+{
+    return m_data;
+}
+
+std::size_t MappedFile::size() const
+{
+    return m_size;
+}
+
+
+} // namespace openll
@@ -0,0 +1,77 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <string>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Read-only memory mapping of a file
+*
+*    The file is mapped for the lifetime of the object.
+*/
+class MappedFile
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] filename
+    *    Path to the file to map
+    */
+    explicit MappedFile(const std::string & filename);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *    Unmaps the file.
+    */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    /**
+    *  @brief
+    *    Check if the file is mapped
+    *
+    *  @return
+    *    'true' if the file could be opened and mapped, else 'false'
+    */
+    bool isValid() const;
+
+    /**
+    *  @brief
+    *    Get mapped contents
+    *
+    *  @return
+    *    Pointer to the first byte of the file, 'nullptr' if not mapped
+    */
+    const unsigned char * data() const;
+
+    /**
+    *  @brief
+    *    Get file size
+    *
+    *  @return
+    *    Size of the file in bytes
+    */
+    std::size_t size() const;
+
+
+protected:
+    const unsigned char * m_data;    ///< Mapped contents
+    std::size_t           m_size;    ///< Size of the file in bytes
+    void                * m_handle;  ///< Platform handle of the mapping (Windows only)
+};
+
+
+} // namespace openll
@@ -0,0 +1,67 @@
+
+#include "StreamSegments.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace openll
+{
+
+
+StreamSegments::StreamSegments(const std::size_t numSegments, const std::size_t capacity)
+: m_numSegments(numSegments)
+, m_capacity(capacity)
+, m_segment(numSegments > 0 ? numSegments - 1 : 0) // The first segment is written first
+, m_size(0)
+{
+}
+
+StreamSegments::~StreamSegments()
+{
+}
+
+std::size_t StreamSegments::numSegments() const
+{
+    return m_numSegments;
+}
+
+std::size_t StreamSegments::capacity() const
+{
+    return m_capacity;
+}
+
+std::size_t StreamSegments::begin()
+{
+    assert(m_numSegments > 0);
+
+    m_segment = (m_segment + 1) % m_numSegments;
+    m_size = 0;
+
+    return m_segment;
+}
+
+void StreamSegments::end(const std::size_t count)
+{
+    assert(count <= m_capacity);
+
+    m_size = std::min(count, m_capacity);
+}
+
+std::size_t StreamSegments::segment() const
+{
+    return m_segment;
+}
+
+std::size_t StreamSegments::offset() const
+{
+    return m_segment * m_capacity;
+}
+
+std::size_t StreamSegments::size() const
+{
+    return m_size;
+}
+
+
+} // namespace openll
@@ -0,0 +1,121 @@
+
+#pragma once
+
+
+#include <cstddef>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Bookkeeping of the segments of a streamed buffer
+*
+*    A streamed buffer is divided into a number of segments of equal
+*    capacity that are written in turn, one per frame. Tracks the segment
+*    that is currently written or drawn and the number of elements it
+*    holds.
+*
+*    Used by GlyphVertexCloud to stream vertices. Requires no OpenGL
+*    context.
+*/
+class OPENLL_API StreamSegments
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] numSegments
+    *    Number of segments (0 if not streaming)
+    *  @param[in] capacity
+    *    Number of elements per segment (0 if not streaming)
+    */
+    explicit StreamSegments(std::size_t numSegments = 0, std::size_t capacity = 0);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~StreamSegments();
+
+    /**
+    *  @brief
+    *    Get number of segments
+    *
+    *  @return
+    *    Number of segments
+    */
+    std::size_t numSegments() const;
+
+    /**
+    *  @brief
+    *    Get number of elements per segment
+    *
+    *  @return
+    *    Capacity of each segment
+    */
+    std::size_t capacity() const;
+
+    /**
+    *  @brief
+    *    Switch to the next segment
+    *
+    *    The first call selects the first segment. The selected segment is
+    *    empty until end() is called.
+    *
+    *  @return
+    *    Index of the selected segment
+    */
+    std::size_t begin();
+
+    /**
+    *  @brief
+    *    Set the number of elements written to the current segment
+    *
+    *  @param[in] count
+    *    Number of elements (clamped to capacity())
+    */
+    void end(std::size_t count);
+
+    /**
+    *  @brief
+    *    Get index of the current segment
+    *
+    *  @return
+    *    Index of the current segment
+    */
+    std::size_t segment() const;
+
+    /**
+    *  @brief
+    *    Get index of the first element of the current segment
+    *
+    *  @return
+    *    Offset of the current segment within the buffer
+    */
+    std::size_t offset() const;
+
+    /**
+    *  @brief
+    *    Get number of elements of the current segment
+    *
+    *  @return
+    *    Number of elements passed to the last end(), 0 while writing
+    */
+    std::size_t size() const;
+
+
+protected:
+    std::size_t m_numSegments; ///< Number of segments
+    std::size_t m_capacity;    ///< Number of elements per segment
+    std::size_t m_segment;     ///< Index of the current segment
+    std::size_t m_size;        ///< Number of elements of the current segment
+};
+
+
+} // namespace openll
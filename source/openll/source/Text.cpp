@@ -1,11 +1,35 @@
 
 #include <openll/Text.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include <openll/BreakIndex.h>
+
+
+namespace
+{
+
+
+std::uint64_t nextGeneration()
+{
+    static std::atomic<std::uint64_t> generation(0);
+
+    return ++generation;
+}
+
+
+} // namespace
+
 
 namespace openll
 {
 
 
+const std::size_t Text::numCachedBreakIndices;
+
+
 char32_t Text::defaultLineFeed()
 {
     static const auto LF = static_cast<char32_t>('\x0A');
@@ -14,6 +38,7 @@ char32_t Text::defaultLineFeed()
 
 Text::Text()
 : m_linefeed(Text::defaultLineFeed())
+, m_generation(nextGeneration())
 {
 }
 
@@ -29,11 +54,17 @@ const std::u32string & Text::text() const
 void Text::setText(const std::u32string & text)
 {
     m_text = text;
+    m_generation = nextGeneration();
+
+    clearBreakIndices();
 }
 
 void Text::setText(std::u32string && text)
 {
     m_text = std::move(text);
+    m_generation = nextGeneration();
+
+    clearBreakIndices();
 }
 
 char32_t Text::lineFeed() const
@@ -44,6 +75,54 @@ char32_t Text::lineFeed() const
 void Text::setLineFeed(char32_t linefeed)
 {
     m_linefeed = linefeed;
+    m_generation = nextGeneration();
+
+    clearBreakIndices();
+}
+
+std::uint64_t Text::generation() const
+{
+    return m_generation;
+}
+
+std::shared_ptr<const BreakIndex> Text::breakIndex(const FontFace & fontFace, const LineBreakTable & lineBreakTable) const
+{
+    // Replace an index built for the same font face and line break table, else an empty entry
+    auto replaced = m_breakIndices.size();
+
+    for (auto i = std::size_t(0); i < m_breakIndices.size(); ++i)
+    {
+        const auto breakIndex = std::atomic_load(&m_breakIndices[i]);
+
+        if (breakIndex && breakIndex->isValid(fontFace, lineBreakTable))
+        {
+            return breakIndex;
+        }
+
+        if (!breakIndex || breakIndex->isBuiltFor(fontFace, lineBreakTable))
+        {
+            replaced = std::min(replaced, i);
+        }
+    }
+
+    // Else, each combination replaces a fixed entry, so concurrent calls need no coordination
+    if (replaced == m_breakIndices.size())
+    {
+        replaced = (std::hash<const void *>()(&fontFace) ^ std::hash<const void *>()(&lineBreakTable)) % m_breakIndices.size();
+    }
+
+    const auto breakIndex = std::make_shared<const BreakIndex>(m_text, m_linefeed, fontFace, lineBreakTable);
+    std::atomic_store(&m_breakIndices[replaced], breakIndex);
+
+    return breakIndex;
+}
+
+void Text::clearBreakIndices()
+{
+    for (auto & breakIndex : m_breakIndices)
+    {
+        std::atomic_store(&breakIndex, std::shared_ptr<const BreakIndex>());
+    }
 }
 
 
@@ -1,10 +1,10 @@
 
 #include <openll/Typesetter.h>
 
-#include <set>
 #include <algorithm>
+#include <cstring>
 #include <vector>
-#include <mutex>
+#include <thread>
 
 #include <glm/common.hpp>
 #include <glm/geometric.hpp>
@@ -15,32 +15,310 @@
 
 #include <openll/Text.h>
 #include <openll/Alignment.h>
+#include <openll/BreakIndex.h>
 #include <openll/FontFace.h>
+#include <openll/GlyphMetricsTable.h>
 #include <openll/Label.h>
+#include <openll/LabelLayout.h>
+#include <openll/LineBreakTable.h>
+
+#include "VertexTransform.h"
 
 
 namespace
 {
 
 
-// Setup common delimiters for wordwrapping
-// Note: u32string::find outperforms set::count here (tested)
-auto delimiters = std::u32string({ '\x0A', ' ', ',', '.', '-', '/', '(', ')', '[', ']', '<', '>', '.' });
-const auto delimiterSet = std::set<char32_t>(delimiters.begin(), delimiters.end());
-std::once_flag onceFlag;
+// Reusable scratch storage for optimizing vertex arrays
+struct SortScratch
+{
+    std::vector<std::uint32_t>                    glyphIndices;     ///< Glyph index of each vertex
+    std::vector<std::uint32_t>                    swapGlyphIndices; ///< Target of a radix pass for glyph indices
+    std::vector<openll::GlyphVertexCloud::Vertex> swapVertices;     ///< Target of a radix pass for vertices
+};
+
+thread_local SortScratch sortScratch;
+
+
+// Reusable scratch storage for typesetting into a vertex sink
+thread_local std::vector<openll::GlyphVertexCloud::Vertex> sinkScratch;
+
+
+// Reusable scratch storage for typesetting into a streaming vertex cloud
+thread_local std::vector<openll::GlyphVertexCloud::Vertex> streamScratch;
+
+
+// Glyph metrics and kernings of a font face, looked up lazily by the measurement engine.
+// Entries are validated by a stamp, so switching the font face invalidates the cache in O(1).
+// The kerning entries (128 KB) are only allocated once a font face with kernings is measured.
+class MeasureCache
+{
+public:
+    struct Metrics
+    {
+        float advance;   ///< Horizontal advance of the glyph
+        bool depictable; ///< Does the glyph produce a vertex?
+    };
+
+    static const char32_t numGlyphs = 256;   ///< Code points with cached metrics
+    static const char32_t numKerned = 128;   ///< Code points with cached kerning pairs
+
+public:
+    MeasureCache()
+    : m_fontFace(nullptr)
+    , m_generation(0)
+    , m_stamp(0)
+    , m_kerned(false)
+    {
+    }
+
+    void select(const openll::FontFace & fontFace)
+    {
+        // Font face generations are globally unique, so a new font face at the same address is detected as well
+        if (m_fontFace == &fontFace && m_generation == fontFace.generation())
+        {
+            return;
+        }
+
+        m_fontFace = &fontFace;
+        m_generation = fontFace.generation();
+        m_kerned = fontFace.hasKerning();
+
+        if (m_glyphStamps.empty())
+        {
+            m_glyphStamps.resize(numGlyphs, 0);
+            m_glyphs.resize(numGlyphs);
+        }
+
+        if (m_kerned && m_kerningStamps.empty())
+        {
+            m_kerningStamps.resize(numKerned * numKerned, 0);
+            m_kernings.resize(numKerned * numKerned);
+        }
+
+        // Reset all stamps on overflow, so no stale entry becomes valid again
+        if (++m_stamp == 0)
+        {
+            std::fill(m_glyphStamps.begin(), m_glyphStamps.end(), 0);
+            std::fill(m_kerningStamps.begin(), m_kerningStamps.end(), 0);
+            m_stamp = 1;
+        }
+    }
+
+    Metrics glyph(const char32_t character)
+    {
+        if (character >= numGlyphs)
+        {
+            return metrics(m_fontFace->glyph(character));
+        }
+
+        if (m_glyphStamps[character] != m_stamp)
+        {
+            m_glyphs[character] = metrics(m_fontFace->glyph(character));
+            m_glyphStamps[character] = m_stamp;
+        }
+
+        return m_glyphs[character];
+    }
+
+    float kerning(const char32_t first, const char32_t second)
+    {
+        if (!m_kerned)
+        {
+            return 0.0f;
+        }
+
+        if (first >= numKerned || second >= numKerned)
+        {
+            return m_fontFace->kerning(first, second);
+        }
+
+        const auto pair = first * numKerned + second;
+
+        if (m_kerningStamps[pair] != m_stamp)
+        {
+            m_kernings[pair] = m_fontFace->kerning(first, second);
+            m_kerningStamps[pair] = m_stamp;
+        }
+
+        return m_kernings[pair];
+    }
+
+protected:
+    static Metrics metrics(const openll::Glyph & glyph)
+    {
+        return Metrics{ glyph.advance(), glyph.depictable() };
+    }
+
+protected:
+    const openll::FontFace   * m_fontFace;      ///< Font face of the cached entries
+    std::uint64_t              m_generation;    ///< Generation of the font face when it was selected
+    std::uint32_t              m_stamp;         ///< Stamp of valid entries
+    bool                       m_kerned;        ///< Does the font face have kerning pairs?
+    std::vector<std::uint32_t> m_glyphStamps;   ///< Stamp of each glyph entry
+    std::vector<Metrics>       m_glyphs;        ///< Glyph metrics by code point
+    std::vector<std::uint32_t> m_kerningStamps; ///< Stamp of each kerning entry
+    std::vector<float>         m_kernings;      ///< Kerning by pair of code points
+};
+
+thread_local MeasureCache measureCache;
+
+
+// Minimum text length measured per thread by Typesetter::extents(), so spawning a thread and
+// filling its measure cache is amortized
+const auto minParallelMeasureLength = std::size_t(16384);
+
+
+// Find the end of a line without word wrap (behind the next line feed)
+std::size_t lineEnd(const std::u32string & text, const char32_t lineFeed, const std::size_t begin)
+{
+    const auto lineFeedIndex = text.find(lineFeed, begin);
+
+    return lineFeedIndex != std::u32string::npos ? lineFeedIndex + 1 : text.size();
+}
+
 
-inline bool isDelimiter(const char32_t character)
+// Stable LSD radix sort of vertices by glyph index, scattering vertices directly.
+// Returns whether the sorted vertices ended up in the swap storage of the sort scratch.
+bool sortByGlyphIndex(openll::GlyphVertexCloud::Vertex * vertices, const std::size_t size, std::vector<std::uint32_t> & glyphIndices)
 {
-    // Set test
-    // return delimiterSet.find(character) != delimiterSet.end();
+    static const auto digitBits = 11u;
+    static const auto numDigits = 1u << digitBits;
+
+    assert(glyphIndices.size() == size);
+
+    auto & swapGlyphIndices = sortScratch.swapGlyphIndices;
+    auto & swapVertices = sortScratch.swapVertices;
+
+    auto source = vertices;
+
+    std::uint32_t histogram[numDigits];
+    for (auto shift = 0u; shift < 32u; shift += digitBits)
+    {
+        std::fill(histogram, histogram + numDigits, 0u);
+
+        for (const auto glyphIndex : glyphIndices)
+        {
+            ++histogram[(glyphIndex >> shift) & (numDigits - 1)];
+        }
+
+        // Skip pass if all glyph indices share the same digit
+        if (std::find(histogram, histogram + numDigits, std::uint32_t(size)) != histogram + numDigits)
+        {
+            continue;
+        }
+
+        // Exclusive prefix sum yields the first target index of each digit
+        auto sum = 0u;
+        for (auto & count : histogram)
+        {
+            const auto current = count;
+            count = sum;
+            sum += current;
+        }
 
-    // Vector search
-    // return std::find(delimiters.begin(), delimiters.end(), character) != delimiters.end();
+        swapGlyphIndices.resize(size);
+        swapVertices.resize(size);
+
+        // Passes alternate between the vertices and the swap storage
+        const auto target = source == vertices ? swapVertices.data() : vertices;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            const auto index = histogram[(glyphIndices[i] >> shift) & (numDigits - 1)]++;
+            swapGlyphIndices[index] = glyphIndices[i];
+            target[index] = source[i];
+        }
 
-    // Sorted vector binary search
-    std::call_once( onceFlag, []{ std::sort(delimiters.begin(), delimiters.end()); });
+        std::swap(glyphIndices, swapGlyphIndices);
+        source = target;
+    }
 
-    return std::binary_search(delimiters.begin(), delimiters.end(), character);
+    return source != vertices;
+}
+
+
+// Typeset labels one after another into the next segment of a streaming vertex cloud.
+// Labels that do not fit into the remaining capacity of the segment are dropped, which
+// asserts in debug builds and leaves an empty range in the positions.
+// Layout, transformation, and sorting read back the vertices, so they are typeset into CPU
+// memory and copied into the write-only segment at once.
+template <typename Labels, typename LabelAccess>
+glm::vec2 typesetStream(openll::GlyphVertexCloud & vertexCloud, const Labels & labels, LabelAccess access, const bool optimize, const bool dryrun
+    , std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions)
+{
+    const openll::FontFace * fontFace = nullptr;
+
+    const auto capacity = vertexCloud.streamCapacity();
+
+    // The scratch storage only grows
+    auto & vertices = streamScratch;
+    if (!dryrun)
+    {
+        vertices.resize(std::max(vertices.size(), capacity));
+    }
+
+    auto size = std::size_t(0);
+    auto extent = glm::vec2(0.0f, 0.0f);
+
+    for (const auto & entry : labels)
+    {
+        const openll::Label * label = access(entry);
+
+        assert(label && label->fontFace());
+        assert(fontFace == nullptr || label->fontFace() == fontFace);
+
+        if (!label || !label->fontFace() || !label->text())
+        {
+            continue;
+        }
+
+        if (!fontFace)
+        {
+            fontFace = label->fontFace();
+        }
+
+        if (dryrun)
+        {
+            extent = glm::max(extent, openll::Typesetter::extent(*label));
+            continue;
+        }
+
+        // Each character produces at most one vertex, so only count them if the text does not fit
+        const auto remaining = capacity - size;
+        const auto fits = label->text()->text().size() <= remaining || openll::Typesetter::vertexCount(*label) <= remaining;
+        assert(fits);
+
+        auto count = std::size_t(0);
+        if (fits)
+        {
+            extent = glm::max(extent, openll::Typesetter::typeset(vertices.data() + size, remaining, *label, &count, optimize));
+        }
+
+        if (positions != nullptr)
+        {
+            positions->emplace_back(std::uint32_t(size), std::uint32_t(size + count));
+        }
+
+        size += count;
+    }
+
+    if (dryrun)
+    {
+        return extent;
+    }
+
+    // Wait for the segment only after typesetting
+    const auto segment = vertexCloud.beginStream();
+    std::memcpy(segment, vertices.data(), size * sizeof(openll::GlyphVertexCloud::Vertex));
+    vertexCloud.endStream(size);
+
+    if (fontFace != nullptr)
+    {
+        vertexCloud.setFontFace(fontFace);
+    }
+
+    return extent;
 }
 
 
@@ -53,18 +331,95 @@ namespace openll
 
 glm::vec2 Typesetter::extent(const Label & label)
 {
-    // Abort operation if no font face is set
-    if (!label.fontFace())
+    // Abort operation if no font face or text is set
+    if (!label.fontFace() || !label.text())
     {
         return glm::vec2();
     }
 
-    // Prepare empty vertex list for dry run
-    std::vector<GlyphVertexCloud::Vertex> vertices;
-    std::map<size_t, std::vector<size_t>> buckets;
+    measureCache.select(*label.fontFace());
 
-    // Typeset text with default font size
-    return typeset_label(vertices, buckets, label, false, true);
+    // Measure text with default font size
+    return extent_transform(label, measure_label(label));
+}
+
+std::vector<glm::vec2> Typesetter::extents(const std::vector<const Label *> & labels, bool parallel)
+{
+    auto extents = std::vector<glm::vec2>(labels.size(), glm::vec2());
+
+    const auto textLength = [](const Label * label) -> size_t
+    {
+        return label && label->text() ? label->text()->text().size() : 0;
+    };
+
+    const auto measureRange = [&labels, &extents](const size_t begin, const size_t end)
+    {
+        for (auto i = begin; i != end; ++i)
+        {
+            // Abort if label is not valid
+            assert(labels[i]);
+            if (!labels[i])
+            {
+                continue;
+            }
+
+            const auto & label = *labels[i];
+
+            // Skip labels without font face or text
+            if (!label.fontFace() || !label.text())
+            {
+                continue;
+            }
+
+            measureCache.select(*label.fontFace());
+
+            extents[i] = extent_transform(label, measure_label(label));
+        }
+    };
+
+    // Only use as many threads as there is enough text for
+    auto totalLength = size_t(0);
+    if (parallel)
+    {
+        for (const auto label : labels)
+        {
+            totalLength += textLength(label);
+        }
+    }
+
+    const auto numThreads = std::min(size_t(std::max(std::thread::hardware_concurrency(), 1u)), totalLength / minParallelMeasureLength);
+
+    if (numThreads <= 1)
+    {
+        measureRange(0, labels.size());
+
+        return extents;
+    }
+
+    // Split labels into contiguous chunks of roughly equal text length
+    const auto chunkLength = totalLength / numThreads + 1;
+
+    std::vector<std::thread> threads;
+    auto begin = size_t(0);
+    auto length = size_t(0);
+    for (size_t i = 0; i < labels.size(); ++i)
+    {
+        length += textLength(labels[i]);
+
+        if (length >= chunkLength || i + 1 == labels.size())
+        {
+            threads.emplace_back(measureRange, begin, i + 1);
+            begin = i + 1;
+            length = 0;
+        }
+    }
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    return extents;
 }
 
 glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const Label & label, bool optimize, bool dryrun)
@@ -77,40 +432,173 @@ glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const Label & labe
         return glm::vec2();
     }
 
+    // Typeset into the next segment of a streaming vertex cloud
+    if (vertexCloud.isStreaming())
+    {
+        const Label * labels[] = { &label };
+
+        return typesetStream(vertexCloud, labels, [](const Label * entry) { return entry; }, optimize, dryrun, nullptr);
+    }
+
     // Clear vertex cloud
     vertexCloud.vertices().clear();
 
-    // Setup map for optimizing vertex array
-    std::map<size_t, std::vector<size_t>> buckets;
+    // Setup glyph indices for optimizing vertex array
+    auto & glyphIndices = sortScratch.glyphIndices;
+    glyphIndices.clear();
 
     // Typeset single label
-    auto extent = typeset_label(vertexCloud.vertices(), buckets, label, optimize, dryrun);
+    auto extent = typeset_label(vertexCloud.vertices(), glyphIndices, label, optimize, dryrun);
 
     // Optimize vertex cloud
     if (optimize)
     {
-        optimize_vertices(vertexCloud.vertices(), buckets);
+        optimize_vertices(vertexCloud.vertices(), glyphIndices);
+    }
+
+    // Update vertex array
+    vertexCloud.update();
+
+    // Set font face, whose glyph texture is resolved when rendering
+    vertexCloud.setFontFace(label.fontFace());
+
+    // Give back extent
+    return extent;
+}
+
+std::size_t Typesetter::vertexCount(const Label & label)
+{
+    // Abort operation if no font face or text is set
+    if (!label.fontFace() || !label.text())
+    {
+        return 0;
+    }
+
+    auto & cache = measureCache;
+    cache.select(*label.fontFace());
+
+    auto count = std::size_t(0);
+    for (const auto character : label.text()->text())
+    {
+        count += cache.glyph(character).depictable ? 1 : 0;
+    }
+
+    return count;
+}
+
+glm::vec2 Typesetter::typeset(GlyphVertexCloud::Vertex * vertices, std::size_t capacity, const Label & label, std::size_t * count, bool optimize)
+{
+    if (count)
+    {
+        *count = 0;
+    }
+
+    // Abort operation if no font face or text is set
+    if (!label.fontFace() || !label.text())
+    {
+        return glm::vec2();
+    }
+
+    // Each character produces at most one vertex, so only count them for smaller buffers
+    const auto sufficient = capacity >= label.text()->text().size() || capacity >= vertexCount(label);
+    assert(sufficient);
+
+    if (!sufficient)
+    {
+        return glm::vec2();
+    }
+
+    // Setup glyph indices for optimizing vertex array
+    auto & glyphIndices = sortScratch.glyphIndices;
+    glyphIndices.clear();
+
+    // Layout glyphs in font face space, directly in the buffer
+    auto size = std::size_t(0);
+    const auto extent = layout_label(vertices, size, glyphIndices, label, optimize, false, nullptr);
+
+    // Transform glyphs into output space
+    vertex_transform(label.transform(), label.textColor(), vertices, 0, size);
+
+    // Optimize vertices
+    if (optimize)
+    {
+        optimize_vertices(vertices, size, glyphIndices);
+    }
+
+    if (count)
+    {
+        *count = size;
+    }
+
+    return extent_transform(label, extent);
+}
+
+glm::vec2 Typesetter::typeset(const VertexSink & sink, const Label & label)
+{
+    // Abort operation if no font face or text is set
+    if (!label.fontFace() || !label.text())
+    {
+        return glm::vec2();
+    }
+
+    // The scratch storage only grows, each line reuses it from the start
+    auto & vertices = sinkScratch;
+    vertices.resize(std::max(vertices.size(), vertexCount(label)));
+
+    const LineHandler onLine = [&sink, &label](GlyphVertexCloud::Vertex * lineVertices, std::size_t lineCount)
+    {
+        if (lineCount == 0)
+        {
+            return;
+        }
+
+        vertex_transform(label.transform(), label.textColor(), lineVertices, 0, lineCount);
+        sink(lineVertices, lineCount);
+    };
+
+    auto size = std::size_t(0);
+    std::vector<std::uint32_t> glyphIndices;
+    const auto extent = layout_label(vertices.data(), size, glyphIndices, label, false, false, nullptr, &onLine);
+
+    return extent_transform(label, extent);
+}
+
+glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const std::vector<Label> & labels, bool optimize, bool dryrun, std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions, bool parallel)
+{
+    // Typeset into the next segment of a streaming vertex cloud
+    if (vertexCloud.isStreaming())
+    {
+        return typesetStream(vertexCloud, labels, [](const Label & entry) { return &entry; }, optimize, dryrun, positions);
     }
 
+    // Typeset labels into the vertex list of the vertex cloud
+    const auto extent = typeset(vertexCloud.vertices(), labels, optimize, dryrun, positions, parallel);
+
     // Update vertex array
     vertexCloud.update();
 
-    // Set font texture
-    vertexCloud.setTexture(label.fontFace()->glyphTexture());
+    // Set font face (of the first label with a font face), whose glyph texture is resolved when rendering
+    const auto first = std::find_if(labels.cbegin(), labels.cend(), [](const Label & label) { return label.fontFace() != nullptr; });
+
+    if (first != labels.cend())
+    {
+        vertexCloud.setFontFace(first->fontFace());
+    }
 
     // Give back extent
     return extent;
 }
 
-glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const std::vector<Label> & labels, bool optimize, bool dryrun, std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions)
+glm::vec2 Typesetter::typeset(std::vector<GlyphVertexCloud::Vertex> & vertices, const std::vector<Label> & labels, bool optimize, bool dryrun, std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions, bool parallel)
 {
     const FontFace * fontFace = nullptr;
 
-    // Clear vertex cloud
-    vertexCloud.vertices().clear();
+    // Clear vertex list
+    vertices.clear();
 
-    // Setup map for optimizing vertex array
-    std::map<size_t, std::vector<size_t>> buckets;
+    // Setup glyph indices for optimizing vertex array
+    auto & glyphIndices = sortScratch.glyphIndices;
+    glyphIndices.clear();
 
     // Typeset labels
     glm::vec2 extent(0.0f, 0.0f);
@@ -126,35 +614,37 @@ glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const std::vector<
             fontFace = label.fontFace();
         }
 
+        // Labels are typeset concurrently below
+        if (parallel)
+        {
+            continue;
+        }
+
         // Abort operation if no font face is set
         if (label.fontFace())
         {
             // Typeset label
-            const auto startIndex = std::uint32_t(vertexCloud.vertices().size());
-            const auto currentExtent = typeset_label(vertexCloud.vertices(), buckets, label, optimize, dryrun);
+            const auto startIndex = std::uint32_t(vertices.size());
+            const auto currentExtent = typeset_label(vertices, glyphIndices, label, optimize, dryrun);
             extent = glm::max(extent, currentExtent);
 
             if (positions != nullptr)
             {
-                const auto endIndex = std::uint32_t(vertexCloud.vertices().size());
+                const auto endIndex = std::uint32_t(vertices.size());
                 positions->emplace_back(startIndex, endIndex);
             }
         }
     }
 
-    // Optimize vertex cloud
-    if (optimize)
+    if (parallel)
     {
-        optimize_vertices(vertexCloud.vertices(), buckets);
+        extent = typeset_parallel(vertices, glyphIndices, labels, optimize, dryrun, positions);
     }
 
-    // Update vertex array
-    vertexCloud.update();
-
-    // Set font texture
-    if (fontFace != nullptr)
+    // Optimize vertex list
+    if (optimize)
     {
-        vertexCloud.setTexture(fontFace->glyphTexture());
+        optimize_vertices(vertices, glyphIndices);
     }
 
     // Give back extent
@@ -165,11 +655,18 @@ glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const std::vector<
 {
     const FontFace * fontFace = nullptr;
 
+    // Typeset into the next segment of a streaming vertex cloud
+    if (vertexCloud.isStreaming())
+    {
+        return typesetStream(vertexCloud, labels, [](const Label * entry) { return entry; }, optimize, dryrun, nullptr);
+    }
+
     // Clear vertex cloud
     vertexCloud.vertices().clear();
 
-    // Setup map for optimizing vertex array
-    std::map<size_t, std::vector<size_t>> buckets;
+    // Setup glyph indices for optimizing vertex array
+    auto & glyphIndices = sortScratch.glyphIndices;
+    glyphIndices.clear();
 
     // Typeset labels
     glm::vec2 extent(0.0f, 0.0f);
@@ -196,7 +693,7 @@ glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const std::vector<
             }
 
             // Typeset label
-            auto currenExtent = typeset_label(vertexCloud.vertices(), buckets, *label, optimize, dryrun);
+            auto currenExtent = typeset_label(vertexCloud.vertices(), glyphIndices, *label, optimize, dryrun);
             extent = glm::vec2(glm::max(extent.x, currenExtent.x), glm::max(extent.y, currenExtent.y));
         }
     }
@@ -204,195 +701,454 @@ glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const std::vector<
     // Optimize vertex cloud
     if (optimize)
     {
-        optimize_vertices(vertexCloud.vertices(), buckets);
+        optimize_vertices(vertexCloud.vertices(), glyphIndices);
     }
 
     // Update vertex array
     vertexCloud.update();
 
+    // Set font face (of the first label with a font face), whose glyph texture is resolved when rendering
+    if (fontFace)
+    {
+        vertexCloud.setFontFace(fontFace);
+    }
+
     // Give back extent
     return extent;
 }
 
-inline glm::vec2 Typesetter::typeset_label(std::vector<GlyphVertexCloud::Vertex> & vertices, std::map<size_t, std::vector<size_t>> & buckets, const Label & label, bool optimize, bool dryrun)
+void Typesetter::layout(LabelLayout & layout, const Label & label)
 {
-    struct SegmentInformation
+    layout.m_vertices.clear();
+    layout.m_lineExtents.clear();
+    layout.m_extent = glm::vec2(0.0f, 0.0f);
+
+    // Remember state of the label for validation
+    layout.m_layoutGeneration = label.layoutGeneration();
+    layout.m_text = label.text().get();
+    layout.m_textGeneration = label.text() ? label.text()->generation() : 0;
+    layout.m_fontFaceGeneration = label.fontFace() ? label.fontFace()->generation() : 0;
+    layout.m_lineBreakTableGeneration = label.lineBreakTable().generation();
+
+    // Abort operation if no font face or text is set
+    if (!label.fontFace() || !label.text())
     {
-        glm::vec2 firstDepictablePen;
-        glm::vec2 lastDepictablePen;
-        size_t startGlyphIndex;
-    };
+        return;
+    }
 
-    // Get font face
-    const auto & fontFace = *label.fontFace();
+    // Layout glyphs in font face space
+    layout.m_vertices.resize(vertexCount(label));
 
-    // Append vertex cloud: the maximum number of visible glyphs is the size of the string
-    if (!dryrun)
+    auto count = std::size_t(0);
+    std::vector<std::uint32_t> glyphIndices;
+    layout.m_extent = layout_label(layout.m_vertices.data(), count, glyphIndices, label, false, false, &layout.m_lineExtents);
+}
+
+glm::vec2 Typesetter::typeset(GlyphVertexCloud & vertexCloud, const LabelLayout & layout, const Label & label)
+{
+    assert(layout.isValid(label));
+
+    // Transform glyphs of the layout into output space
+    auto & vertices = vertexCloud.vertices();
+    vertices = layout.m_vertices;
+
+    vertex_transform(label.transform(), label.textColor(), vertices.data(), 0, vertices.size());
+
+    // Update vertex array
+    vertexCloud.update();
+
+    // Abort operation if no font face or text is set
+    if (!label.fontFace() || !label.text())
     {
-        vertices.reserve(vertices.size() + label.text()->text().size());
+        return glm::vec2(0.0f, 0.0f);
     }
 
-    size_t glyphCloudStart = vertices.size();
+    // Set font face, whose glyph texture is resolved when rendering
+    vertexCloud.setFontFace(label.fontFace());
 
-    auto extent = glm::vec2(0.0f, 0.0f);
+    // Give back extent
+    return extent_transform(label, layout.m_extent);
+}
+
+glm::vec2 Typesetter::typeset(GlyphVertexCloud::Vertex * vertices, std::size_t capacity, const LabelLayout & layout, const Label & label)
+{
+    assert(layout.isValid(label));
+    assert(capacity >= layout.m_vertices.size());
+
+    // Abort operation if no font face or text is set, or the buffer is too small
+    if (!label.fontFace() || !label.text() || capacity < layout.m_vertices.size())
+    {
+        return glm::vec2(0.0f, 0.0f);
+    }
 
-    const auto itBegin = label.text()->text().cbegin();
-    const auto itEnd = label.text()->text().cend();
+    // Transform glyphs of the layout into output space
+    std::copy(layout.m_vertices.cbegin(), layout.m_vertices.cend(), vertices);
 
-    auto currentPen = glm::vec2(0.0f, label.lineAnchorOffset());
-    SegmentInformation currentLine = { currentPen, currentPen, glyphCloudStart };
-    SegmentInformation lineForward = { currentPen, currentPen, glyphCloudStart };
+    vertex_transform(label.transform(), label.textColor(), vertices, 0, layout.m_vertices.size());
 
-    const auto lineWidth = glm::max(label.lineWidth() * label.fontFace()->size() / label.fontSize(), 0.0f);
+    // Give back extent
+    return extent_transform(label, layout.m_extent);
+}
 
-    auto index = glyphCloudStart;
-    bool firstDepictablePenInvalid = true;
-    for (auto it = itBegin; it != itEnd; ++it)
+glm::vec2 Typesetter::typeset_parallel(std::vector<GlyphVertexCloud::Vertex> & vertices, std::vector<std::uint32_t> & glyphIndices, const std::vector<Label> & labels, bool optimize, bool dryrun, std::vector<std::pair<std::uint32_t, std::uint32_t>> * positions)
+{
+    struct Chunk
     {
-        const auto & glyph = fontFace.glyph(*it);
+        size_t begin;                                     ///< Index of first label
+        size_t end;                                       ///< Index behind last label
+        std::vector<GlyphVertexCloud::Vertex> vertices;   ///< Vertices of all labels in the chunk
+        std::vector<std::uint32_t> glyphIndices;          ///< Glyph index of each vertex in the chunk
+        glm::vec2 extent;                                 ///< Maximum extent of all labels in the chunk
+        size_t offset;                                    ///< Index of first vertex in the resulting vertex array
+    };
 
-        if (firstDepictablePenInvalid && glyph.depictable())
-        {
-            currentLine.firstDepictablePen = currentPen;
-            firstDepictablePenInvalid = false;
-        }
+    // Partition labels into contiguous chunks of similar text length
+    const auto numLabels = labels.size();
+    const auto numThreads = std::max(size_t(std::thread::hardware_concurrency()), size_t(1));
 
-        // Handle line feeds as well as word wrap for next word
-        // (or next glyph if word width exceeds the max line width)
-        const auto kerning = (it != itBegin ? fontFace.kerning(*(it - 1), *it) : 0.f);
-        const auto feedLine = *it == label.text()->lineFeed() || (label.wordWrap() &&
-            typeset_wordwrap(label, lineWidth, currentPen, glyph, kerning));
+    size_t totalLength = 0;
+    for (const auto & label : labels)
+    {
+        totalLength += label.text() ? label.text()->text().size() : 0;
+    }
 
-        if (feedLine)
+    std::vector<Chunk> chunks;
+    chunks.reserve(numThreads);
+
+    const auto chunkLength = totalLength / numThreads + 1;
+    size_t length = 0;
+    for (size_t i = 0; i < numLabels; ++i)
+    {
+        if (chunks.empty() || (length >= chunkLength && chunks.size() < numThreads))
         {
-            assert(it != itBegin);
+            chunks.push_back(Chunk{ i, i, {}, {}, glm::vec2(0.0f, 0.0f), 0 });
+            length = 0;
+        }
 
-            extent.x = glm::max(currentLine.lastDepictablePen.x, extent.x);
-            extent.y += fontFace.lineHeight();
+        length += labels[i].text() ? labels[i].text()->text().size() : 0;
+        chunks.back().end = i + 1;
+    }
 
-            const auto lineHeight = fontFace.lineHeight();
+    // Typeset each chunk into its own vertex range (glyph counts per label are stored as positions)
+    auto counts = std::vector<std::uint32_t>(numLabels, 0);
 
-            currentPen.y -= lineHeight;
+    const auto typesetChunk = [&labels, &counts, optimize, dryrun](Chunk & chunk)
+    {
+        for (auto i = chunk.begin; i != chunk.end; ++i)
+        {
+            const auto & label = labels[i];
 
-            // Handle newline and alignment
-            if (!dryrun)
+            if (label.fontFace())
             {
-                typeset_align(currentLine.lastDepictablePen, label.alignment(), vertices, currentLine.startGlyphIndex, lineForward.startGlyphIndex);
+                const auto startIndex = chunk.vertices.size();
+                const auto currentExtent = typeset_label(chunk.vertices, chunk.glyphIndices, label, optimize, dryrun);
+                chunk.extent = glm::max(chunk.extent, currentExtent);
+                counts[i] = std::uint32_t(chunk.vertices.size() - startIndex);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunks.size());
+    for (auto & chunk : chunks)
+    {
+        threads.emplace_back(typesetChunk, std::ref(chunk));
+    }
 
-                // Omit relayouting
-                const auto xOffset = currentLine.firstDepictablePen.x;
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
 
-                for (auto j = lineForward.startGlyphIndex; j != index; ++j)
-                {
-                    auto & v = vertices[j];
-                    v.origin.x -= xOffset;
+    threads.clear();
 
-                    v.origin.y -= lineHeight;
-                }
+    // Place vertex ranges via prefix sum over the glyph counts
+    auto extent = glm::vec2(0.0f, 0.0f);
+    auto offset = std::uint32_t(vertices.size());
+    for (auto & chunk : chunks)
+    {
+        chunk.offset = offset;
+        extent = glm::max(extent, chunk.extent);
 
-                currentPen.x = std::max(lineForward.startGlyphIndex >= index ? 0.0f : currentPen.x - xOffset, 0.0f);
-                currentLine.startGlyphIndex = lineForward.startGlyphIndex;
-                lineForward.startGlyphIndex = index;
-            }
-            else
+        for (auto i = chunk.begin; i != chunk.end; ++i)
+        {
+            if (positions != nullptr && labels[i].fontFace())
             {
-                currentPen.x = lineForward.lastDepictablePen.x - currentLine.firstDepictablePen.x;
+                positions->emplace_back(offset, offset + counts[i]);
             }
 
-            currentLine.lastDepictablePen = currentPen;
-            lineForward.firstDepictablePen = glm::vec2(0.0f, currentPen.y);
-            lineForward.lastDepictablePen = currentPen;
-        }
-        else
-        {   // Apply kerning if no line feed precedes
-            currentPen.x += kerning;
+            offset += counts[i];
         }
+    }
+
+    vertices.resize(offset);
 
-        // Typeset glyphs in vertex cloud (only if renderable)
-        if (!dryrun && glyph.depictable())
+    for (auto & chunk : chunks)
+    {
+        threads.emplace_back([&vertices](const Chunk & chunk)
         {
-            vertices.push_back(GlyphVertexCloud::Vertex());
-            typeset_glyph(vertices, buckets, index, currentPen, glyph, optimize);
-            ++index;
-        }
+            std::copy(chunk.vertices.cbegin(), chunk.vertices.cend(), vertices.begin() + chunk.offset);
+        }, std::cref(chunk));
+    }
 
-        currentPen.x += glyph.advance();
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    // Concatenate glyph indices in chunk order, matching the vertex order
+    if (optimize)
+    {
+        glyphIndices.resize(offset);
 
-        if (glyph.depictable())
+        for (const auto & chunk : chunks)
         {
-            lineForward.lastDepictablePen = currentPen;
+            std::copy(chunk.glyphIndices.cbegin(), chunk.glyphIndices.cend(), glyphIndices.begin() + chunk.offset);
         }
+    }
 
-        if (feedLine || isDelimiter(glyph.index()))
-        {
-            currentLine.lastDepictablePen = lineForward.lastDepictablePen;
-            firstDepictablePenInvalid = true;
+    return extent;
+}
 
-            if (!dryrun)
-            {
-                lineForward.startGlyphIndex = index;
-            }
-        }
+inline glm::vec2 Typesetter::typeset_label(std::vector<GlyphVertexCloud::Vertex> & vertices, std::vector<std::uint32_t> & glyphIndices, const Label & label, bool optimize, bool dryrun)
+{
+    const auto glyphCloudStart = vertices.size();
+
+    // Append exactly the number of vertices that is produced
+    if (!dryrun)
+    {
+        vertices.resize(glyphCloudStart + vertexCount(label));
     }
 
-    // Handle alignment (when last line of the label is processed)
-    extent.x = glm::max(lineForward.lastDepictablePen.x, extent.x);
-    extent.y += fontFace.lineHeight();
+    // Layout glyphs in font face space
+    auto count = glyphCloudStart;
+    const auto extent = layout_label(vertices.data(), count, glyphIndices, label, optimize, dryrun, nullptr);
+
+    assert(dryrun || count == vertices.size());
 
+    // Transform glyphs into output space
     if (!dryrun)
     {
-        typeset_align(lineForward.lastDepictablePen, label.alignment(), vertices, currentLine.startGlyphIndex, index);
-        vertex_transform(label.transform(), label.textColor(), vertices, glyphCloudStart, index);
+        vertex_transform(label.transform(), label.textColor(), vertices.data(), glyphCloudStart, count);
     }
 
     return extent_transform(label, extent);
 }
 
-inline bool Typesetter::typeset_wordwrap(
-  const Label & label
-, float lineWidth
-, const glm::vec2 & pen
-, const Glyph & glyph
-, const float kerning)
+inline glm::vec2 Typesetter::layout_label(GlyphVertexCloud::Vertex * vertices, std::size_t & count, std::vector<std::uint32_t> & glyphIndices, const Label & label, bool optimize, bool dryrun, std::vector<glm::vec2> * lineExtents, const LineHandler * onLine)
 {
-    assert(label.wordWrap());
+    // Get font face
+    const auto & fontFace = *label.fontFace();
+
+    const auto & text = label.text()->text();
+    const auto lineFeed = label.text()->lineFeed();
+    const auto lineHeight = fontFace.lineHeight();
+
+    // Count locally, so the compiler does not need to assume that the vertices alias it
+    auto size = count;
+
+    // Word wrap uses the break index of the text, which is cached across calls
+    const auto breakIndex = label.wordWrap() ? label.text()->breakIndex(fontFace, label.lineBreakTable()) : nullptr;
+    const auto lineWidth = glm::max(label.lineWidth() * fontFace.size() / label.fontSize(), 0.0f);
+    const auto kerned = fontFace.hasKerning();
+
+    // Only the packed glyph metrics are accessed per glyph
+    const auto & metrics = fontFace.glyphMetrics();
+    const auto advances = metrics.advances().data();
+    const auto depictables = metrics.depictables().data();
+    const auto penRectangles = metrics.penRectangles().data();
+    const auto subtextureRectangles = metrics.subtextureRectangles().data();
+    const auto indices = metrics.indices().data();
 
-    if (!glyph.depictable() || (glyph.advance() > lineWidth && pen.x <= 0.0f))
+    auto extent = glm::vec2(0.0f, 0.0f);
+    auto pen = glm::vec2(0.0f, label.lineAnchorOffset());
+
+    auto begin = size_t(0);
+    while (true)
     {
-        return false;
+        const auto end = begin == text.size() ? begin
+            : breakIndex ? breakIndex->lineEnd(begin, lineWidth) : lineEnd(text, lineFeed, begin);
+
+        const auto lineStart = size;
+        auto width = 0.0f;
+
+        if (breakIndex)
+        {
+            // Pen positions are given by the break index
+            width = static_cast<float>(breakIndex->width(begin, end));
+
+            const auto origin = begin != end ? breakIndex->pen(begin) : 0.0;
+
+            for (auto i = begin; i != end && !dryrun; ++i)
+            {
+                const auto id = fontFace.glyphId(text[i]);
+
+                if (depictables[id])
+                {
+                    pen.x = static_cast<float>(breakIndex->pen(i) - origin);
+
+                    typeset_glyph(vertices, glyphIndices, size++, pen, penRectangles[id], subtextureRectangles[id], indices[id], optimize);
+                }
+            }
+        }
+        else
+        {
+            pen.x = 0.0f;
+
+            for (auto i = begin; i != end; ++i)
+            {
+                const auto id = fontFace.glyphId(text[i]);
+
+                // Apply kerning if no line feed precedes
+                if (i != begin && kerned)
+                {
+                    pen.x += fontFace.kerning(text[i - 1], text[i]);
+                }
+
+                // Typeset glyphs in vertex cloud (only if renderable)
+                if (!dryrun && depictables[id])
+                {
+                    typeset_glyph(vertices, glyphIndices, size++, pen, penRectangles[id], subtextureRectangles[id], indices[id], optimize);
+                }
+
+                pen.x += advances[id];
+
+                if (depictables[id])
+                {
+                    width = pen.x;
+                }
+            }
+        }
+
+        extent.x = glm::max(width, extent.x);
+        extent.y += lineHeight;
+
+        if (lineExtents)
+        {
+            lineExtents->emplace_back(width, lineHeight);
+        }
+
+        // Handle alignment
+        if (!dryrun)
+        {
+            typeset_align(glm::vec2(width, pen.y), label.alignment(), vertices, lineStart, size);
+        }
+
+        // Hand over the vertices of the line and reuse their storage
+        if (onLine)
+        {
+            (*onLine)(vertices + lineStart, size - lineStart);
+            size = lineStart;
+        }
+
+        // A line feed at the end of the text starts another (empty) line
+        if (end == text.size() && (end == begin || text[end - 1] != lineFeed))
+        {
+            break;
+        }
+
+        pen.y -= lineHeight;
+        begin = end;
     }
 
-    return pen.x + glyph.advance() + kerning > lineWidth;
+    count = size;
+
+    return extent;
+}
+
+inline glm::vec2 Typesetter::measure_label(const Label & label)
+{
+    // This replicates layout_label in dry run mode using the glyph metrics cache
+    auto & cache = measureCache;
+
+    const auto & fontFace = *label.fontFace();
+
+    const auto & text = label.text()->text();
+    const auto lineFeed = label.text()->lineFeed();
+    const auto lineHeight = fontFace.lineHeight();
+
+    const auto breakIndex = label.wordWrap() ? label.text()->breakIndex(fontFace, label.lineBreakTable()) : nullptr;
+    const auto lineWidth = glm::max(label.lineWidth() * fontFace.size() / label.fontSize(), 0.0f);
+
+    auto extent = glm::vec2(0.0f, 0.0f);
+
+    auto begin = size_t(0);
+    while (true)
+    {
+        const auto end = begin == text.size() ? begin
+            : breakIndex ? breakIndex->lineEnd(begin, lineWidth) : lineEnd(text, lineFeed, begin);
+
+        auto width = 0.0f;
+
+        if (breakIndex)
+        {
+            width = static_cast<float>(breakIndex->width(begin, end));
+        }
+        else
+        {
+            auto pen = 0.0f;
+
+            for (auto i = begin; i != end; ++i)
+            {
+                const auto glyph = cache.glyph(text[i]);
+
+                if (i != begin)
+                {
+                    pen += cache.kerning(text[i - 1], text[i]);
+                }
+
+                pen += glyph.advance;
+
+                if (glyph.depictable)
+                {
+                    width = pen;
+                }
+            }
+        }
+
+        extent.x = glm::max(width, extent.x);
+        extent.y += lineHeight;
+
+        if (end == text.size() && (end == begin || text[end - 1] != lineFeed))
+        {
+            break;
+        }
+
+        begin = end;
+    }
+
+    return extent;
 }
 
 inline void Typesetter::typeset_glyph(
-  std::vector<GlyphVertexCloud::Vertex> & vertices
-, std::map<size_t, std::vector<size_t>> & buckets
+  GlyphVertexCloud::Vertex * vertices
+, std::vector<std::uint32_t> & glyphIndices
 , size_t index
 , const glm::vec2 & pen
-, const Glyph & glyph
+, const glm::vec4 & penRectangle
+, const glm::vec4 & subtextureRectangle
+, std::uint32_t glyphIndex
 , bool optimize)
 {
     assert(pen.x >= 0.0f);
 
     auto & vertex = vertices[index];
 
-    vertex.origin = glm::vec3(pen + glyph.penOrigin(), 0.0f);
-    vertex.vtan   = glm::vec3(glyph.penTangent(), 0.f);
-    vertex.vbitan = glm::vec3(glyph.penBitangent(), 0.f);
-    vertex.uvRect = glyph.subtextureRectangle();
+    vertex.origin = glm::vec3(pen.x + penRectangle.x, pen.y + penRectangle.y, 0.0f);
+    vertex.vtan   = glm::vec3(penRectangle.z, 0.0f, 0.0f);
+    vertex.vbitan = glm::vec3(0.0f, penRectangle.w, 0.0f);
+    vertex.uvRect = subtextureRectangle;
 
     if (optimize)
     {
-        auto glyphIndex = glyph.index();
-        buckets[glyphIndex].push_back(index);
+        glyphIndices.push_back(glyphIndex);
     }
 }
 
 inline void Typesetter::typeset_align(
   const glm::vec2 & pen
 , const Alignment alignment
-, std::vector<GlyphVertexCloud::Vertex> & vertices
+, GlyphVertexCloud::Vertex * vertices
 , size_t begin
 , size_t end)
 {
@@ -416,31 +1172,20 @@ inline void Typesetter::typeset_align(
     }
 }
 
-inline void Typesetter::vertex_transform(
+void Typesetter::vertex_transform(
   const glm::mat4 & transform
 , const glm::vec4 & textColor
-, std::vector<GlyphVertexCloud::Vertex> & vertices
+, GlyphVertexCloud::Vertex * vertices
 , size_t begin
 , size_t end)
 {
-    for (auto i = begin; i != end; ++i)
-    {
-        auto & v = vertices[i];
-
-        assert(v.origin.z == 0.0f);
+    assert(begin <= end);
 
-        const auto ll = transform * glm::vec4(v.origin, 1.f);
-        const auto lr = transform * glm::vec4(v.origin + v.vtan, 1.f);
-        const auto ul = transform * glm::vec4(v.origin + v.vbitan, 1.f);
-
-        v.origin = glm::vec3(ll);
-        v.vtan   = glm::vec3(lr - ll);
-        v.vbitan = glm::vec3(ul - ll);
-        v.textColor = textColor;
-    }
+    // Tangent and bitangent only need the linear part of the transform (see VertexTransform.h)
+    transformVertices(transform, textColor, vertices + begin, end - begin);
 }
 
-inline glm::vec2 Typesetter::extent_transform(
+glm::vec2 Typesetter::extent_transform(
   const Label & label
 , const glm::vec2 & extent)
 {
@@ -451,23 +1196,21 @@ inline glm::vec2 Typesetter::extent_transform(
     return glm::vec2(glm::distance(lr, ll), glm::distance(ul, ll));
 }
 
-inline void Typesetter::optimize_vertices(std::vector<GlyphVertexCloud::Vertex> & vertices, const std::map<size_t, std::vector<size_t>> & buckets)
+inline void Typesetter::optimize_vertices(std::vector<GlyphVertexCloud::Vertex> & vertices, std::vector<std::uint32_t> & glyphIndices)
 {
-    std::vector<GlyphVertexCloud::Vertex> sorted;
-
-    sorted.reserve(vertices.size());
-
-    for (const auto & it : buckets)
+    // The previous array is kept as scratch storage for the next call
+    if (sortByGlyphIndex(vertices.data(), vertices.size(), glyphIndices))
     {
-        const auto & bucket = it.second;
-
-        for (size_t i=0; i<bucket.size(); ++i)
-        {
-            sorted.emplace_back(vertices[bucket[i]]);
-        }
+        std::swap(vertices, sortScratch.swapVertices);
     }
+}
 
-    std::swap(vertices, sorted);
+inline void Typesetter::optimize_vertices(GlyphVertexCloud::Vertex * vertices, std::size_t size, std::vector<std::uint32_t> & glyphIndices)
+{
+    if (sortByGlyphIndex(vertices, size, glyphIndices))
+    {
+        std::copy(sortScratch.swapVertices.cbegin(), sortScratch.swapVertices.cbegin() + size, vertices);
+    }
 }
 
 
@@ -0,0 +1,66 @@
+
+#include "UpdateFrequency.h"
+
+#include <cassert>
+
+
+namespace openll
+{
+
+
+UpdateFrequency::UpdateFrequency(const std::size_t numUpdates, const std::size_t numFrames)
+: m_numFrames(numFrames)
+, m_frame(0)
+, m_frames(numUpdates, 0)
+, m_next(0)
+, m_numRecorded(0)
+{
+    assert(numUpdates > 0);
+}
+
+UpdateFrequency::~UpdateFrequency()
+{
+}
+
+void UpdateFrequency::update()
+{
+    if (m_frames.empty())
+    {
+        return;
+    }
+
+    // Further updates of the current frame are not recorded
+    const auto newest = (m_next + m_frames.size() - 1) % m_frames.size();
+
+    if (m_numRecorded > 0 && m_frames[newest] == m_frame)
+    {
+        return;
+    }
+
+    m_frames[m_next] = m_frame;
+    m_next = (m_next + 1) % m_frames.size();
+
+    if (m_numRecorded < m_frames.size())
+    {
+        ++m_numRecorded;
+    }
+}
+
+void UpdateFrequency::draw()
+{
+    ++m_frame;
+}
+
+bool UpdateFrequency::isFrequent() const
+{
+    if (m_frames.empty() || m_numRecorded < m_frames.size())
+    {
+        return false;
+    }
+
+    // The oldest of the recorded frames is overwritten next
+    return m_frame - m_frames[m_next] < m_numFrames;
+}
+
+
+} // namespace openll
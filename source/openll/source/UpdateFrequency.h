@@ -0,0 +1,79 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+
+#include <openll/openll_api.h>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Detection of buffers that are updated on most frames
+*
+*    Records the frames, counted by draw calls, in which a buffer has
+*    been updated. The buffer is updated frequently if it has been updated
+*    in a number of frames within a window of recent frames. Several
+*    updates between two draw calls count as a single one, so building
+*    up a buffer before it is drawn is not mistaken for frequent updates.
+*
+*    Used by GlyphVertexCloud to choose the usage hint of its vertex
+*    buffer. Requires no OpenGL context.
+*/
+class OPENLL_API UpdateFrequency
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] numUpdates
+    *    Number of frames with updates that indicate frequent updates (at least 1)
+    *  @param[in] numFrames
+    *    Number of most recent frames the updates have to fall into
+    */
+    UpdateFrequency(std::size_t numUpdates, std::size_t numFrames);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~UpdateFrequency();
+
+    /**
+    *  @brief
+    *    Record an update in the current frame
+    */
+    void update();
+
+    /**
+    *  @brief
+    *    Record a draw call, which ends the current frame
+    */
+    void draw();
+
+    /**
+    *  @brief
+    *    Check if the updates are frequent
+    *
+    *  @return
+    *    'true' if the last numUpdates frames with updates are within the last numFrames frames, else 'false'
+    */
+    bool isFrequent() const;
+
+
+protected:
+    std::size_t              m_numFrames;   ///< Number of most recent frames the updates have to fall into
+    std::size_t              m_frame;       ///< Index of the current frame (number of draw calls)
+    std::vector<std::size_t> m_frames;      ///< Frames with updates (ring buffer of numUpdates entries)
+    std::size_t              m_next;        ///< Index of the oldest entry, which is overwritten next
+    std::size_t              m_numRecorded; ///< Number of recorded frames with updates (up to numUpdates)
+};
+
+
+} // namespace openll
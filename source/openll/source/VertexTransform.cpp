@@ -0,0 +1,324 @@
+
+#include "VertexTransform.h"
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define OPENLL_VERTEX_TRANSFORM_X86
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+
+    // MSVC allows AVX2 intrinsics in any function, GCC and Clang require the target attribute.
+    // Note: FMA is not enabled on purpose, as fused operations would round differently than the scalar fallback.
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define OPENLL_TARGET_AVX2
+    #else
+        #define OPENLL_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+
+namespace
+{
+
+
+using Vertex = openll::GlyphVertexCloud::Vertex;
+
+// Origin, tangent, and bitangent are processed as an array of 9 floats
+static_assert(offsetof(Vertex, vtan) == 3 * sizeof(float) && offsetof(Vertex, vbitan) == 6 * sizeof(float), "Unexpected layout of GlyphVertexCloud::Vertex");
+
+
+using Kernel = void (*)(const float * matrix, const glm::vec4 & textColor, Vertex * vertices, std::size_t count);
+
+
+// The matrix is passed as 4 columns of 3 rows (the projective row is ignored).
+// All kernels evaluate ((m0 * x + m1 * y) + m2 * z) [+ m3] in this exact order.
+
+void transformScalar(const float * m, const glm::vec4 & textColor, Vertex * vertices, std::size_t count)
+{
+    for (auto i = std::size_t(0); i < count; ++i)
+    {
+        auto & v = vertices[i];
+
+        const auto o = v.origin;
+        const auto t = v.vtan;
+        const auto b = v.vbitan;
+
+        v.origin = glm::vec3(
+            ((m[0] * o.x + m[3] * o.y) + m[6] * o.z) + m[9]
+        ,   ((m[1] * o.x + m[4] * o.y) + m[7] * o.z) + m[10]
+        ,   ((m[2] * o.x + m[5] * o.y) + m[8] * o.z) + m[11]);
+
+        v.vtan = glm::vec3(
+            (m[0] * t.x + m[3] * t.y) + m[6] * t.z
+        ,   (m[1] * t.x + m[4] * t.y) + m[7] * t.z
+        ,   (m[2] * t.x + m[5] * t.y) + m[8] * t.z);
+
+        v.vbitan = glm::vec3(
+            (m[0] * b.x + m[3] * b.y) + m[6] * b.z
+        ,   (m[1] * b.x + m[4] * b.y) + m[7] * b.z
+        ,   (m[2] * b.x + m[5] * b.y) + m[8] * b.z);
+
+        v.textColor = textColor;
+    }
+}
+
+
+#ifdef OPENLL_VERTEX_TRANSFORM_X86
+
+// The first 9 floats of a vertex (origin, vtan, vbitan) are loaded as two
+// vectors of 4 floats and a single float. Transposing the vectors of 4 glyphs
+// yields one vector per component, so each kernel processes 4 (SSE2) or
+// 2 x 4 (AVX2, one group per 128 bit lane) glyphs at once.
+
+inline void transpose4(__m128 & r0, __m128 & r1, __m128 & r2, __m128 & r3)
+{
+    const auto t0 = _mm_unpacklo_ps(r0, r1);
+    const auto t1 = _mm_unpackhi_ps(r0, r1);
+    const auto t2 = _mm_unpacklo_ps(r2, r3);
+    const auto t3 = _mm_unpackhi_ps(r2, r3);
+
+    r0 = _mm_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+inline __m128 linear4(const __m128 * m, const __m128 x, const __m128 y, const __m128 z)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0], x), _mm_mul_ps(m[3], y)), _mm_mul_ps(m[6], z));
+}
+
+void transformSSE2(const float * m, const glm::vec4 & textColor, Vertex * vertices, std::size_t count)
+{
+    __m128 columns[12];
+    for (auto i = 0; i < 12; ++i)
+    {
+        columns[i] = _mm_set1_ps(m[i]);
+    }
+
+    const auto batchEnd = count - count % 4;
+
+    for (auto i = std::size_t(0); i < batchEnd; i += 4)
+    {
+        float * p[4];
+        for (auto j = 0; j < 4; ++j)
+        {
+            p[j] = &vertices[i + j].origin.x;
+        }
+
+        // a = (ox, oy, oz, tx), b = (ty, tz, bx, by), c = bz
+        __m128 a[4], b[4];
+        for (auto j = 0; j < 4; ++j)
+        {
+            a[j] = _mm_loadu_ps(p[j]);
+            b[j] = _mm_loadu_ps(p[j] + 4);
+        }
+
+        const auto c = _mm_setr_ps(p[0][8], p[1][8], p[2][8], p[3][8]);
+
+        transpose4(a[0], a[1], a[2], a[3]);
+        transpose4(b[0], b[1], b[2], b[3]);
+
+        // Transform
+        const __m128 o[3] = { a[0], a[1], a[2] };
+        const __m128 t[3] = { a[3], b[0], b[1] };
+        const __m128 s[3] = { b[2], b[3], c    };
+
+        __m128 result[9];
+        for (auto r = 0; r < 3; ++r)
+        {
+            result[r]     = _mm_add_ps(linear4(columns + r, o[0], o[1], o[2]), columns[9 + r]);
+            result[3 + r] = linear4(columns + r, t[0], t[1], t[2]);
+            result[6 + r] = linear4(columns + r, s[0], s[1], s[2]);
+        }
+
+        transpose4(result[0], result[1], result[2], result[3]);
+        transpose4(result[4], result[5], result[6], result[7]);
+
+        alignas(16) float last[4];
+        _mm_store_ps(last, result[8]);
+
+        for (auto j = 0; j < 4; ++j)
+        {
+            _mm_storeu_ps(p[j], result[j]);
+            _mm_storeu_ps(p[j] + 4, result[4 + j]);
+            p[j][8] = last[j];
+
+            vertices[i + j].textColor = textColor;
+        }
+    }
+
+    transformScalar(m, textColor, vertices + batchEnd, count - batchEnd);
+}
+
+OPENLL_TARGET_AVX2
+inline void transpose4(__m256 & r0, __m256 & r1, __m256 & r2, __m256 & r3)
+{
+    const auto t0 = _mm256_unpacklo_ps(r0, r1);
+    const auto t1 = _mm256_unpackhi_ps(r0, r1);
+    const auto t2 = _mm256_unpacklo_ps(r2, r3);
+    const auto t3 = _mm256_unpackhi_ps(r2, r3);
+
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+OPENLL_TARGET_AVX2
+inline __m256 load2x4(const float * lower, const float * upper)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lower)), _mm_loadu_ps(upper), 1);
+}
+
+OPENLL_TARGET_AVX2
+inline __m256 linear8(const __m256 * m, const __m256 x, const __m256 y, const __m256 z)
+{
+    return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[0], x), _mm256_mul_ps(m[3], y)), _mm256_mul_ps(m[6], z));
+}
+
+OPENLL_TARGET_AVX2
+void transformAVX2(const float * m, const glm::vec4 & textColor, Vertex * vertices, std::size_t count)
+{
+    __m256 columns[12];
+    for (auto i = 0; i < 12; ++i)
+    {
+        columns[i] = _mm256_set1_ps(m[i]);
+    }
+
+    const auto batchEnd = count - count % 8;
+
+    for (auto i = std::size_t(0); i < batchEnd; i += 8)
+    {
+        float * p[8];
+        for (auto j = 0; j < 8; ++j)
+        {
+            p[j] = &vertices[i + j].origin.x;
+        }
+
+        // Glyphs 0-3 in the lower lane, glyphs 4-7 in the upper lane
+        __m256 a[4], b[4];
+        for (auto j = 0; j < 4; ++j)
+        {
+            a[j] = load2x4(p[j], p[4 + j]);
+            b[j] = load2x4(p[j] + 4, p[4 + j] + 4);
+        }
+
+        const auto c = _mm256_setr_ps(p[0][8], p[1][8], p[2][8], p[3][8], p[4][8], p[5][8], p[6][8], p[7][8]);
+
+        transpose4(a[0], a[1], a[2], a[3]);
+        transpose4(b[0], b[1], b[2], b[3]);
+
+        // Transform
+        const __m256 o[3] = { a[0], a[1], a[2] };
+        const __m256 t[3] = { a[3], b[0], b[1] };
+        const __m256 s[3] = { b[2], b[3], c    };
+
+        __m256 result[9];
+        for (auto r = 0; r < 3; ++r)
+        {
+            result[r]     = _mm256_add_ps(linear8(columns + r, o[0], o[1], o[2]), columns[9 + r]);
+            result[3 + r] = linear8(columns + r, t[0], t[1], t[2]);
+            result[6 + r] = linear8(columns + r, s[0], s[1], s[2]);
+        }
+
+        transpose4(result[0], result[1], result[2], result[3]);
+        transpose4(result[4], result[5], result[6], result[7]);
+
+        alignas(32) float last[8];
+        _mm256_store_ps(last, result[8]);
+
+        for (auto j = 0; j < 4; ++j)
+        {
+            _mm_storeu_ps(p[j],         _mm256_castps256_ps128(result[j]));
+            _mm_storeu_ps(p[j] + 4,     _mm256_castps256_ps128(result[4 + j]));
+            _mm_storeu_ps(p[4 + j],     _mm256_extractf128_ps(result[j], 1));
+            _mm_storeu_ps(p[4 + j] + 4, _mm256_extractf128_ps(result[4 + j], 1));
+        }
+
+        for (auto j = 0; j < 8; ++j)
+        {
+            p[j][8] = last[j];
+
+            vertices[i + j].textColor = textColor;
+        }
+    }
+
+    // Remaining glyphs
+    transformSSE2(m, textColor, vertices + batchEnd, count - batchEnd);
+}
+
+bool supportsAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    // AVX and OSXSAVE, and the OS saves the ymm registers
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif
+
+
+Kernel selectKernel()
+{
+#ifdef OPENLL_VERTEX_TRANSFORM_X86
+    // SSE2 is part of x86-64
+    return supportsAVX2() ? &transformAVX2 : &transformSSE2;
+#else
+    return &transformScalar;
+#endif
+}
+
+void linearMatrix(const glm::mat4 & transform, float * m)
+{
+    for (auto c = 0; c < 4; ++c)
+    {
+        for (auto r = 0; r < 3; ++r)
+        {
+            m[c * 3 + r] = transform[c][r];
+        }
+    }
+}
+
+
+} // namespace
+
+
+namespace openll
+{
+
+
+void transformVertices(const glm::mat4 & transform, const glm::vec4 & textColor, GlyphVertexCloud::Vertex * vertices, const std::size_t count)
+{
+    static const auto kernel = selectKernel();
+
+    float m[12];
+    linearMatrix(transform, m);
+
+    kernel(m, textColor, vertices, count);
+}
+
+
+} // namespace openll
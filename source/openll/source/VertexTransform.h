@@ -0,0 +1,43 @@
+
+#pragma once
+
+
+#include <cstddef>
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <openll/GlyphVertexCloud.h>
+
+
+namespace openll
+{
+
+
+/**
+*  @brief
+*    Transform glyph vertices and set their text color
+*
+*    The origin of each vertex is transformed by the affine part of the
+*    transformation, while tangent and bitangent are transformed by its
+*    3x3 linear part only. The projective row of the transformation is
+*    ignored.
+*
+*    Uses an AVX2 (8 glyphs) or SSE2 (4 glyphs) kernel if supported by
+*    the CPU, which is determined once at runtime. All kernels, including
+*    the scalar fallback, evaluate the same operations in the same order
+*    and produce bitwise identical results.
+*
+*  @param[in] transform
+*    Transformation matrix
+*  @param[in] textColor
+*    Text color (rgba)
+*  @param[in,out] vertices
+*    Pointer to the first vertex
+*  @param[in] count
+*    Number of vertices
+*/
+void transformVertices(const glm::mat4 & transform, const glm::vec4 & textColor, GlyphVertexCloud::Vertex * vertices, std::size_t count);
+
+
+} // namespace openll
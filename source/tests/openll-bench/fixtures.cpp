@@ -0,0 +1,120 @@
+
+#include "fixtures.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <openll/openll.h>
+#include <openll/FontLoader.h>
+
+
+const std::string & fontFilename()
+{
+    static const auto filename = openll::dataPath() + "/openll/fonts/opensansr36.fnt";
+
+    return filename;
+}
+
+const std::string & largeFontFilename()
+{
+    static const auto filename = []()
+    {
+        const auto numGlyphs = 60000u;
+        const auto numKernings = 500000u;
+
+        auto random = std::mt19937(1337);
+
+        std::ofstream atlas("openll-bench-large.raw", std::ios::out | std::ios::binary | std::ios::trunc);
+        atlas.write(std::vector<char>(256 * 256).data(), 256 * 256);
+
+        std::ofstream out("openll-bench-large.fnt", std::ios::out | std::ios::binary | std::ios::trunc);
+        out << "info face=\"Synthetic\" size=36 bold=0 italic=0 charset=\"\" unicode=1 stretchH=100 smooth=1 aa=1 padding=4,4,4,4 spacing=0,0\n";
+        out << "common lineHeight=49.03 base=34 scaleW=256 scaleH=256 pages=1 packed=0\n";
+        out << "page id=0 file=\"openll-bench-large.raw\"\n";
+        out << "chars count=" << numGlyphs << "\n";
+
+        for (auto i = 0u; i < numGlyphs; ++i)
+        {
+            out << "char id=" << 32 + i << " x=" << random() % 256 << " y=" << random() % 256
+                << " width=" << random() % 40 << " height=" << random() % 40
+                << " xoffset=" << (random() % 400) / 100.0f << " yoffset=" << (random() % 4000) / 100.0f
+                << " xadvance=" << (random() % 4000) / 100.0f << " page=0 chnl=15\n";
+        }
+
+        // Kernings are listed by first glyph, like in generated font files
+        out << "kernings count=" << numKernings << "\n";
+
+        for (auto i = 0u; i < numKernings; ++i)
+        {
+            out << "kerning first=" << 32 + static_cast<unsigned long long>(i) * numGlyphs / numKernings
+                << " second=" << 32 + random() % numGlyphs
+                << " amount=" << -static_cast<int>(random() % 8) << "\n";
+        }
+
+        std::atexit([]()
+        {
+            std::remove("openll-bench-large.fnt");
+            std::remove("openll-bench-large.raw");
+        });
+
+        return std::string("openll-bench-large.fnt");
+    }();
+
+    return filename;
+}
+
+openll::FontFace & fontFace()
+{
+    static const auto fontFace = openll::FontLoader::load(fontFilename());
+
+    if (!fontFace)
+    {
+        std::cerr << "Cannot load " << fontFilename() << std::endl;
+        std::abort();
+    }
+
+    return *fontFace;
+}
+
+std::u32string sampleText(const std::size_t length)
+{
+    static const auto letters = std::string("etaoinshrdlucmfwypvbgkjqxzETAOINSHRDLU");
+    static const auto punctuation = std::string(",.;:!?-");
+
+    auto random = std::mt19937(1337);
+    auto text = std::u32string();
+    text.reserve(length);
+
+    // Words of 1 to 10 letters, some followed by punctuation, lines of about 80 characters
+    auto lineLength = std::size_t(0);
+    while (text.size() < length)
+    {
+        const auto wordLength = 1 + random() % 10;
+        for (auto i = 0u; i < wordLength && text.size() < length; ++i)
+        {
+            text.push_back(static_cast<char32_t>(letters[random() % letters.size()]));
+        }
+
+        if (random() % 8 == 0 && text.size() < length)
+        {
+            text.push_back(static_cast<char32_t>(punctuation[random() % punctuation.size()]));
+        }
+
+        lineLength += wordLength + 1;
+        if (text.size() < length)
+        {
+            text.push_back(lineLength > 80 ? U'\n' : U' ');
+        }
+
+        if (lineLength > 80)
+        {
+            lineLength = 0;
+        }
+    }
+
+    return text;
+}
@@ -0,0 +1,45 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <string>
+
+#include <openll/FontFace.h>
+
+
+/**
+*  @brief
+*    Get path of the benchmarked font face description file (opensansr36.fnt)
+*/
+const std::string & fontFilename();
+
+/**
+*  @brief
+*    Get path of a synthetic font face description file with 60k glyphs and 500k kerning pairs
+*
+*    The file and its glyph atlas are written to the working directory on first use
+*    and removed on exit.
+*/
+const std::string & largeFontFilename();
+
+/**
+*  @brief
+*    Get the benchmarked font face
+*
+*  @return
+*    Font face shared by all benchmarks (aborts if the font cannot be loaded)
+*/
+openll::FontFace & fontFace();
+
+/**
+*  @brief
+*    Generate a deterministic text of words, punctuation, and line feeds
+*
+*  @param[in] length
+*    Number of characters
+*
+*  @return
+*    Text of the given length
+*/
+std::u32string sampleText(std::size_t length);
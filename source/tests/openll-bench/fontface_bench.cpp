@@ -0,0 +1,124 @@
+
+#include <cstdio>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <openll/FontFace.h>
+#include <openll/FontLoader.h>
+#include <openll/FontWriter.h>
+#include <openll/Glyph.h>
+
+#include "fixtures.h"
+
+
+namespace
+{
+
+
+const auto lookups = std::size_t(4096);
+
+
+} // namespace
+
+
+// Loading of opensansr36.fnt, including its glyph atlas
+void BM_FontLoaderLoad(benchmark::State & state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(openll::FontLoader::load(fontFilename()));
+    }
+}
+
+BENCHMARK(BM_FontLoaderLoad)
+    ->Unit(benchmark::kMicrosecond);
+
+// Loading of a synthetic description with 60k glyphs and 500k kerning pairs
+void BM_FontLoaderLoadLarge(benchmark::State & state)
+{
+    const auto & filename = largeFontFilename();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(openll::FontLoader::load(filename));
+    }
+}
+
+BENCHMARK(BM_FontLoaderLoadLarge)
+    ->Unit(benchmark::kMillisecond);
+
+// Loading of opensansr36.fnt precompiled to a binary font file
+void BM_FontLoaderLoadBinary(benchmark::State & state)
+{
+    const auto filename = std::string("openll-bench.llf");
+
+    if (!openll::FontWriter::write(fontFace(), filename))
+    {
+        state.SkipWithError("Cannot write binary font");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(openll::FontLoader::load(filename));
+    }
+
+    std::remove(filename.c_str());
+}
+
+BENCHMARK(BM_FontLoaderLoadBinary)
+    ->Unit(benchmark::kMicrosecond);
+
+// FontFace::glyph for the characters of a text
+void BM_FontFaceGlyph(benchmark::State & state)
+{
+    const openll::FontFace & face = fontFace();
+    const auto text = sampleText(lookups);
+
+    for (auto _ : state)
+    {
+        for (const auto character : text)
+        {
+            benchmark::DoNotOptimize(face.glyph(character).advance());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+BENCHMARK(BM_FontFaceGlyph);
+
+// FontFace::kerning for the subsequent characters of a text
+void BM_FontFaceKerning(benchmark::State & state)
+{
+    const openll::FontFace & face = fontFace();
+    const auto text = sampleText(lookups + 1);
+
+    for (auto _ : state)
+    {
+        for (auto i = std::size_t(1); i < text.size(); ++i)
+        {
+            benchmark::DoNotOptimize(face.kerning(text[i - 1], text[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(text.size() - 1));
+}
+
+BENCHMARK(BM_FontFaceKerning);
+
+// FontFace::kerning for a single, repeated pair of characters
+void BM_FontFaceKerningRepeated(benchmark::State & state)
+{
+    const openll::FontFace & face = fontFace();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(face.kerning('A', 'V'));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_FontFaceKerningRepeated);
@@ -0,0 +1,6 @@
+
+#include <benchmark/benchmark.h>
+
+
+// Run with --benchmark_out=<file> --benchmark_out_format=json to track results between releases
+BENCHMARK_MAIN();
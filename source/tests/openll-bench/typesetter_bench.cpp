@@ -0,0 +1,162 @@
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <glm/vec2.hpp>
+
+#include <openll/Alignment.h>
+#include <openll/GlyphVertexCloud.h>
+#include <openll/Label.h>
+#include <openll/LabelLayout.h>
+#include <openll/Text.h>
+#include <openll/Typesetter.h>
+
+#include "fixtures.h"
+
+
+namespace
+{
+
+
+// Text sizes in bytes of UTF-32 text, from 1 KB to 100 MB.
+// Note: the 100 MB cases need about 2 GB of memory, exclude them with --benchmark_filter if necessary.
+const std::int64_t KB = 1024;
+const std::int64_t MB = 1024 * KB;
+const std::int64_t textSizes[] = { 1 * KB, 10 * KB, 100 * KB, 1 * MB, 10 * MB, 100 * MB };
+
+const float lineWidth = 400.0f;
+
+
+// Texts are shared between benchmarks, so they are generated only once per size
+std::shared_ptr<openll::Text> text(const std::int64_t bytes)
+{
+    static std::map<std::int64_t, std::shared_ptr<openll::Text>> texts;
+
+    auto & text = texts[bytes];
+    if (!text)
+    {
+        text = std::make_shared<openll::Text>();
+        text->setText(sampleText(static_cast<std::size_t>(bytes) / sizeof(char32_t)));
+    }
+
+    return text;
+}
+
+openll::Label label(const std::int64_t bytes, const bool wordWrap, const openll::Alignment alignment = openll::Alignment::LeftAligned)
+{
+    auto label = openll::Label();
+    label.setText(text(bytes));
+    label.setFontFace(fontFace());
+    label.setFontSize(16.0f);
+    label.setWordWrap(wordWrap);
+    label.setLineWidth(lineWidth);
+    label.setAlignment(alignment);
+    label.setTransform2D(glm::vec2(-1.0f, 1.0f), glm::uvec2(1920, 1080));
+
+    return label;
+}
+
+// Vertex buffer shared between benchmarks, so it is allocated only once per size
+std::vector<openll::GlyphVertexCloud::Vertex> & vertices(const std::size_t count)
+{
+    static std::vector<openll::GlyphVertexCloud::Vertex> vertices;
+
+    if (vertices.size() < count)
+    {
+        vertices.resize(count);
+    }
+
+    return vertices;
+}
+
+
+void typeset(benchmark::State & state, const openll::Label & label, const bool optimize)
+{
+    auto & buffer = vertices(openll::Typesetter::vertexCount(label));
+
+    auto count = std::size_t(0);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(openll::Typesetter::typeset(buffer.data(), buffer.size(), label, &count, optimize));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(label.text()->text().size() * sizeof(char32_t)));
+    state.counters["glyphs"] = benchmark::Counter(static_cast<double>(count), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+
+} // namespace
+
+
+// Typesetter::typeset across text sizes, word wrap, and optimization (args: bytes, wrap, optimize)
+void BM_Typeset(benchmark::State & state)
+{
+    typeset(state, label(state.range(0), state.range(1) != 0), state.range(2) != 0);
+}
+
+BENCHMARK(BM_Typeset)
+    ->ArgNames({ "bytes", "wrap", "optimize" })
+    ->ArgsProduct({ std::vector<std::int64_t>(std::begin(textSizes), std::end(textSizes)), { 0, 1 }, { 0, 1 } })
+    ->Unit(benchmark::kMicrosecond);
+
+// Typesetter::typeset for each alignment (args: alignment, wrap)
+void BM_TypesetAlignment(benchmark::State & state)
+{
+    const auto alignment = static_cast<openll::Alignment>(state.range(0));
+
+    typeset(state, label(1 * MB, state.range(1) != 0, alignment), false);
+}
+
+BENCHMARK(BM_TypesetAlignment)
+    ->ArgNames({ "alignment", "wrap" })
+    ->ArgsProduct({ { static_cast<std::int64_t>(openll::Alignment::LeftAligned), static_cast<std::int64_t>(openll::Alignment::Centered), static_cast<std::int64_t>(openll::Alignment::RightAligned) }, { 0, 1 } })
+    ->Unit(benchmark::kMicrosecond);
+
+// Typesetter::typeset of a precomputed layout, i.e., the vertex transform stage only (args: glyphs)
+void BM_TransformLayout(benchmark::State & state)
+{
+    const auto label = ::label(static_cast<std::int64_t>(state.range(0) * sizeof(char32_t)), false);
+
+    auto layout = openll::LabelLayout();
+    openll::Typesetter::layout(layout, label);
+
+    auto & buffer = vertices(layout.vertices().size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(openll::Typesetter::typeset(buffer.data(), buffer.size(), layout, label));
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["glyphs"] = benchmark::Counter(static_cast<double>(layout.vertices().size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_TransformLayout)
+    ->ArgName("characters")
+    ->Arg(4096)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMicrosecond);
+
+// Typesetter::extent across text sizes and word wrap (args: bytes, wrap)
+void BM_Extent(benchmark::State & state)
+{
+    const auto label = ::label(state.range(0), state.range(1) != 0);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(openll::Typesetter::extent(label));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Extent)
+    ->ArgNames({ "bytes", "wrap" })
+    ->ArgsProduct({ std::vector<std::int64_t>(std::begin(textSizes), std::end(textSizes)), { 0, 1 } })
+    ->Unit(benchmark::kMicrosecond);
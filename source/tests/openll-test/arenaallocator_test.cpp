@@ -0,0 +1,59 @@
+
+#include <gmock/gmock.h>
+
+#include "ArenaAllocator.h"
+
+
+TEST(arenaallocator_test, AllocatesFirstFit)
+{
+    auto allocator = openll::ArenaAllocator(100);
+
+    EXPECT_EQ(100u, allocator.capacity());
+    EXPECT_EQ(100u, allocator.available());
+
+    EXPECT_EQ(0u, allocator.allocate(30));
+    EXPECT_EQ(30u, allocator.allocate(50));
+    EXPECT_EQ(80u, allocator.allocate(20));
+
+    EXPECT_EQ(0u, allocator.available());
+    EXPECT_EQ(0u, allocator.numFreeBlocks());
+    EXPECT_EQ(openll::ArenaAllocator::invalidOffset, allocator.allocate(1));
+
+    // A freed block is reused by allocations that fit into it
+    allocator.free(30, 50);
+    EXPECT_EQ(openll::ArenaAllocator::invalidOffset, allocator.allocate(51));
+    EXPECT_EQ(30u, allocator.allocate(10));
+    EXPECT_EQ(40u, allocator.allocate(40));
+    EXPECT_EQ(0u, allocator.available());
+}
+
+TEST(arenaallocator_test, MergesFreedBlocks)
+{
+    auto allocator = openll::ArenaAllocator(100);
+
+    const auto a = allocator.allocate(25);
+    const auto b = allocator.allocate(25);
+    const auto c = allocator.allocate(25);
+    const auto d = allocator.allocate(25);
+
+    allocator.free(a, 25);
+    allocator.free(c, 25);
+
+    EXPECT_EQ(2u, allocator.numFreeBlocks());
+    EXPECT_EQ(50u, allocator.available());
+    EXPECT_EQ(25u, allocator.largestFreeBlock());
+
+    // Freeing the block in between merges it with both neighbours
+    allocator.free(b, 25);
+
+    EXPECT_EQ(1u, allocator.numFreeBlocks());
+    EXPECT_EQ(75u, allocator.largestFreeBlock());
+
+    // Freeing the last block restores the empty arena
+    allocator.free(d, 25);
+
+    EXPECT_EQ(1u, allocator.numFreeBlocks());
+    EXPECT_EQ(100u, allocator.available());
+    EXPECT_EQ(100u, allocator.largestFreeBlock());
+    EXPECT_EQ(0u, allocator.allocate(100));
+}
@@ -0,0 +1,230 @@
+
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <openll/BreakIndex.h>
+#include <openll/FontFace.h>
+#include <openll/Glyph.h>
+#include <openll/LineBreakTable.h>
+#include <openll/Text.h>
+
+#include "fixtures.h"
+
+
+class breakindex_test: public testing::Test
+{
+public:
+    breakindex_test()
+    {
+        setupFontFace(m_fontFace);
+    }
+
+    // Width from the pen of the first glyph to the end of the last depictable glyph, accumulated glyph by glyph
+    double referenceWidth(const std::u32string & text, const std::size_t begin, const std::size_t end) const
+    {
+        const auto & fontFace = m_fontFace;
+
+        auto pen = 0.0;
+        auto width = 0.0;
+
+        for (auto i = begin; i < end; ++i)
+        {
+            if (i > begin)
+            {
+                pen += fontFace.kerning(text[i - 1], text[i]);
+            }
+
+            const auto & glyph = fontFace.glyph(text[i]);
+            pen += glyph.advance();
+
+            if (glyph.depictable())
+            {
+                width = pen;
+            }
+        }
+
+        return width;
+    }
+
+    // Find the end of a line by a linear scan over the text, without break index
+    std::size_t referenceLineEnd(const std::u32string & text, const std::size_t begin, const double lineWidth) const
+    {
+        const auto & table = openll::LineBreakTable::defaultTable();
+
+        auto limit = text.find(U'\n', begin);
+        limit = limit == std::u32string::npos ? text.size() : limit + 1;
+
+        if (referenceWidth(text, begin, limit) <= lineWidth)
+        {
+            return limit;
+        }
+
+        // Last break opportunity at which the line fits
+        auto lastBreak = std::size_t(0);
+        for (auto end = begin + 1; end < limit; ++end)
+        {
+            if (openll::LineBreakTable::isBreakOpportunity(table.lineBreakClass(text[end - 1]), table.lineBreakClass(text[end]))
+                && referenceWidth(text, begin, end) <= lineWidth)
+            {
+                lastBreak = end;
+            }
+        }
+
+        if (lastBreak > 0)
+        {
+            return lastBreak;
+        }
+
+        // Break the word behind the last glyph that fits, keeping at least one depictable glyph
+        auto lastFitting = begin;
+        for (auto end = begin + 1; end < limit; ++end)
+        {
+            if (referenceWidth(text, begin, end) <= lineWidth)
+            {
+                lastFitting = end;
+            }
+        }
+
+        auto depictable = false;
+        for (auto i = begin; i < lastFitting; ++i)
+        {
+            depictable = depictable || m_fontFace.glyph(text[i]).depictable();
+        }
+
+        return depictable ? lastFitting : lastFitting + 1;
+    }
+
+    // Compare all lines of a text wrapped with and without break index
+    void expectSameLines(const std::u32string & text, const double lineWidth) const
+    {
+        const auto index = openll::BreakIndex(text, U'\n', m_fontFace, openll::LineBreakTable::defaultTable());
+
+        auto lines = std::vector<std::size_t>();
+        auto referenceLines = std::vector<std::size_t>();
+
+        for (auto begin = std::size_t(0); begin < text.size(); begin = lines.back())
+        {
+            lines.push_back(index.lineEnd(begin, lineWidth));
+            referenceLines.push_back(referenceLineEnd(text, begin, lineWidth));
+
+            ASSERT_GT(lines.back(), begin);
+        }
+
+        EXPECT_EQ(referenceLines, lines) << "line width " << lineWidth;
+    }
+
+protected:
+    openll::FontFace m_fontFace;
+};
+
+TEST_F(breakindex_test, LineEndsMatchLinearScan)
+{
+    const auto texts = std::vector<std::u32string>{
+        U"Kerning AVAVA ToTo and some more words to wrap",
+        U"Supercalifragilisticexpialidocious is a long word, AVeryLongWordWithoutAnyBreakOpportunity",
+        U"Trailing spaces   \nbetween    lines    \n\nand at the end     ",
+        U"Hyphen-ated-words and (brackets), punctuation... done",
+    };
+
+    for (const auto & text : texts)
+    {
+        for (const auto lineWidth : { 5.0, 30.0, 64.0, 100.0, 160.0, 250.0, 10000.0 })
+        {
+            expectSameLines(text, lineWidth);
+        }
+    }
+}
+
+TEST_F(breakindex_test, LongWordIsBrokenBehindLastFittingGlyph)
+{
+    const auto text = std::u32string(U"abcdefghij");
+    const auto index = openll::BreakIndex(text, U'\n', m_fontFace, openll::LineBreakTable::defaultTable());
+
+    // Glyphs a to e advance by 16, 10, 11, 12 and 13, so abcd (49) fits into 50 but abcde (62) does not
+    EXPECT_EQ(4u, index.lineEnd(0, 50.0));
+    EXPECT_EQ(49.0, index.width(0, 4));
+    EXPECT_EQ(62.0, index.width(0, 5));
+
+    // At least one glyph is kept on a line that is too narrow for any glyph
+    EXPECT_EQ(1u, index.lineEnd(0, 1.0));
+}
+
+TEST_F(breakindex_test, TrailingSpacesDoNotCountTowardsWidth)
+{
+    const auto text = std::u32string(U"abc      def");
+    const auto index = openll::BreakIndex(text, U'\n', m_fontFace, openll::LineBreakTable::defaultTable());
+
+    EXPECT_EQ(index.width(0, 3), index.width(0, 9));
+
+    // The spaces stay on the first line, although their advances exceed the line width
+    EXPECT_EQ(9u, index.lineEnd(0, index.width(0, 3)));
+}
+
+TEST_F(breakindex_test, RebuiltAfterTextOrFontFaceChange)
+{
+    const auto & table = openll::LineBreakTable::defaultTable();
+
+    auto text = openll::Text();
+    text.setText(U"Kerning AVAVA ToTo");
+
+    const auto index = text.breakIndex(m_fontFace, table);
+    ASSERT_NE(nullptr, index);
+    EXPECT_TRUE(index->isValid(m_fontFace, table));
+    EXPECT_EQ(index, text.breakIndex(m_fontFace, table));
+
+    // Font face modifications invalidate the index
+    m_fontFace.setKerning('A', 'V', -4.0f);
+    EXPECT_FALSE(index->isValid(m_fontFace, table));
+
+    const auto rebuilt = text.breakIndex(m_fontFace, table);
+    EXPECT_NE(index, rebuilt);
+    EXPECT_TRUE(rebuilt->isValid(m_fontFace, table));
+    EXPECT_LT(rebuilt->pen(text.text().size() - 1), index->pen(text.text().size() - 1));
+
+    // Text modifications replace the index
+    text.setText(U"Another text");
+
+    const auto replaced = text.breakIndex(m_fontFace, table);
+    EXPECT_NE(rebuilt, replaced);
+    EXPECT_EQ(text.text().size(), replaced->size());
+}
+
+TEST_F(breakindex_test, CachedPerFontFaceAndLineBreakTable)
+{
+    const auto & table = openll::LineBreakTable::defaultTable();
+
+    openll::FontFace otherFontFace;
+    setupFontFace(otherFontFace);
+
+    auto otherTable = openll::LineBreakTable();
+
+    auto text = openll::Text();
+    text.setText(U"Kerning AVAVA ToTo");
+
+    const auto index = text.breakIndex(m_fontFace, table);
+    const auto other = text.breakIndex(otherFontFace, table);
+    const auto otherTableIndex = text.breakIndex(m_fontFace, otherTable);
+
+    EXPECT_TRUE(other->isValid(otherFontFace, table));
+    EXPECT_TRUE(otherTableIndex->isValid(m_fontFace, otherTable));
+
+    // Alternating font faces and tables reuses their indices
+    for (auto i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(index, text.breakIndex(m_fontFace, table));
+        EXPECT_EQ(other, text.breakIndex(otherFontFace, table));
+        EXPECT_EQ(otherTableIndex, text.breakIndex(m_fontFace, otherTable));
+    }
+
+    // A modified font face replaces its own index only
+    otherFontFace.setKerning('A', 'V', -4.0f);
+
+    const auto rebuilt = text.breakIndex(otherFontFace, table);
+    EXPECT_NE(other, rebuilt);
+    EXPECT_EQ(rebuilt, text.breakIndex(otherFontFace, table));
+    EXPECT_EQ(index, text.breakIndex(m_fontFace, table));
+    EXPECT_EQ(otherTableIndex, text.breakIndex(m_fontFace, otherTable));
+}
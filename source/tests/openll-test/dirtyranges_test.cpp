@@ -0,0 +1,49 @@
+
+#include <gmock/gmock.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "DirtyRanges.h"
+
+
+using Ranges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+
+TEST(dirtyranges_test, MergesOverlappingAndAdjacentRanges)
+{
+    auto ranges = openll::DirtyRanges();
+
+    EXPECT_TRUE(ranges.empty());
+
+    ranges.add(40, 50);
+    ranges.add(10, 20);
+    ranges.add(15, 25);
+    ranges.add(25, 30);
+    ranges.add(60, 60);
+
+    EXPECT_FALSE(ranges.empty());
+    EXPECT_EQ(Ranges({ { 10, 30 }, { 40, 50 } }), ranges.ranges());
+    EXPECT_EQ(30u, ranges.size());
+
+    // Merged ranges remain valid when adding more
+    ranges.add(0, 5);
+    EXPECT_EQ(Ranges({ { 0, 5 }, { 10, 30 }, { 40, 50 } }), ranges.ranges());
+
+    ranges.clear();
+    EXPECT_TRUE(ranges.empty());
+    EXPECT_TRUE(ranges.ranges().empty());
+}
+
+TEST(dirtyranges_test, MergesWithinMergeDistance)
+{
+    auto ranges = openll::DirtyRanges(8);
+
+    ranges.add(0, 10);
+    ranges.add(18, 20);
+    ranges.add(29, 30);
+
+    EXPECT_EQ(Ranges({ { 0, 20 }, { 29, 30 } }), ranges.ranges());
+    EXPECT_EQ(21u, ranges.size());
+}
@@ -0,0 +1,152 @@
+
+#include <gmock/gmock.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "DrawBatches.h"
+
+
+namespace
+{
+
+
+using Ranges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+
+Ranges batchRanges(const openll::DrawBatches & batches)
+{
+    auto ranges = Ranges();
+
+    for (const auto & batch : batches.batches())
+    {
+        ranges.emplace_back(batch.begin, batch.end);
+    }
+
+    return ranges;
+}
+
+
+} // namespace
+
+
+TEST(drawbatches_test, EmptyListIssuesNothing)
+{
+    auto batches = openll::DrawBatches();
+    batches.build();
+
+    const auto statistics = batches.statistics();
+
+    EXPECT_TRUE(batches.batches().empty());
+    EXPECT_EQ(0u, statistics.numVertexClouds);
+    EXPECT_EQ(0u, statistics.numDrawCalls);
+    EXPECT_EQ(0u, statistics.numProgramChanges);
+    EXPECT_EQ(0u, statistics.numTextureChanges);
+    EXPECT_EQ(0u, statistics.numVertexArrayChanges);
+}
+
+TEST(drawbatches_test, GroupsByTextureAndVertexArray)
+{
+    // Stand-ins for textures and vertex arrays, only their addresses are compared
+    const int textures[2] = { 0, 0 };
+    const int vaos[4] = { 0, 0, 0, 0 };
+
+    auto batches = openll::DrawBatches();
+
+    // Two arena pages, and two vertex clouds with vertex arrays of their own
+    batches.add(&textures[1], &vaos[0], true, 0);
+    batches.add(&textures[0], &vaos[2], false, 1);
+    batches.add(&textures[0], &vaos[0], true, 2);
+    batches.add(&textures[1], &vaos[0], true, 3);
+    batches.add(&textures[0], &vaos[1], true, 4);
+    batches.add(&textures[0], &vaos[0], true, 5);
+    batches.add(&textures[1], &vaos[3], false, 6);
+    batches.add(&textures[1], &vaos[0], true, 7);
+
+    batches.build();
+
+    const auto & entries = batches.entries();
+    ASSERT_EQ(8u, entries.size());
+
+    // Entries of each group keep their order
+    auto indices = std::vector<std::size_t>();
+    for (const auto & entry : entries)
+    {
+        indices.push_back(entry.index);
+    }
+
+    EXPECT_EQ(std::vector<std::size_t>({ 2, 5, 4, 1, 0, 3, 7, 6 }), indices);
+
+    // Entries of an arena page with the same texture are drawn at once
+    EXPECT_EQ(Ranges({ { 0, 2 }, { 2, 3 }, { 3, 4 }, { 4, 7 }, { 7, 8 } }), batchRanges(batches));
+
+    const auto statistics = batches.statistics();
+
+    EXPECT_EQ(8u, statistics.numVertexClouds);
+    EXPECT_EQ(5u, statistics.numDrawCalls);
+    EXPECT_EQ(1u, statistics.numProgramChanges);
+    EXPECT_EQ(2u, statistics.numTextureChanges);
+    EXPECT_EQ(5u, statistics.numVertexArrayChanges);
+}
+
+TEST(drawbatches_test, DoesNotCombineUnsharedVertexArrays)
+{
+    const int texture = 0;
+    const int vao = 0;
+
+    auto batches = openll::DrawBatches();
+
+    batches.add(&texture, &vao, false, 0);
+    batches.add(&texture, &vao, false, 1);
+
+    batches.build();
+
+    EXPECT_EQ(Ranges({ { 0, 1 }, { 1, 2 } }), batchRanges(batches));
+    EXPECT_TRUE(batches.batches()[0].bindTexture);
+    EXPECT_FALSE(batches.batches()[1].bindTexture);
+
+    // Rebuilding starts over
+    batches.clear();
+    batches.build();
+
+    EXPECT_TRUE(batches.entries().empty());
+    EXPECT_TRUE(batches.batches().empty());
+}
+
+TEST(drawbatches_test, SkipsEntriesWithoutTexture)
+{
+    const int textures[1] = { 0 };
+    const int vaos[2] = { 0, 0 };
+
+    auto batches = openll::DrawBatches();
+
+    // Vertex clouds without font face or texture, in between drawable ones of the same page
+    batches.add(&textures[0], &vaos[0], true, 0);
+    batches.add(nullptr, &vaos[0], true, 1);
+    batches.add(&textures[0], &vaos[0], true, 2);
+    batches.add(nullptr, &vaos[1], false, 3);
+    batches.add(&textures[0], nullptr, false, 4);
+    batches.build();
+
+    ASSERT_EQ(2u, batches.entries().size());
+    EXPECT_EQ(0u, batches.entries()[0].index);
+    EXPECT_EQ(2u, batches.entries()[1].index);
+
+    EXPECT_EQ(Ranges({ { 0, 2 } }), batchRanges(batches));
+    EXPECT_TRUE(batches.batches()[0].bindTexture);
+
+    const auto statistics = batches.statistics();
+    EXPECT_EQ(2u, statistics.numVertexClouds);
+    EXPECT_EQ(1u, statistics.numDrawCalls);
+    EXPECT_EQ(1u, statistics.numTextureChanges);
+
+    // Only entries without texture issue nothing
+    batches.clear();
+    batches.add(nullptr, &vaos[1], false, 0);
+    batches.build();
+
+    EXPECT_TRUE(batches.entries().empty());
+    EXPECT_TRUE(batches.batches().empty());
+    EXPECT_EQ(0u, batches.statistics().numDrawCalls);
+}
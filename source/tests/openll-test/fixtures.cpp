@@ -0,0 +1,65 @@
+
+#include "fixtures.h"
+
+#include <glm/vec2.hpp>
+
+#include <openll/Glyph.h>
+#include <openll/Typesetter.h>
+
+
+void setupFontFace(openll::FontFace & fontFace)
+{
+    fontFace.setAscent(28.0f);
+    fontFace.setDescent(-8.0f);
+    fontFace.setLinegap(4.0f);
+    fontFace.setGlyphTextureExtent(glm::uvec2(512, 512));
+
+    for (auto index = size_t(32); index < 127; ++index)
+    {
+        auto glyph = openll::Glyph(nullptr);
+        glyph.setIndex(index);
+        glyph.setAdvance(10.0f + static_cast<float>(index % 7));
+
+        if (index != ' ')
+        {
+            glyph.setSubTextureOrigin(glm::vec2(static_cast<float>(index % 16) / 16.0f, static_cast<float>(index / 16) / 8.0f));
+            glyph.setSubTextureExtent(glm::vec2(1.0f / 16.0f, 1.0f / 8.0f));
+            glyph.setExtent(glm::vec2(12.0f, 24.0f));
+            glyph.setBearing(glm::vec2(1.0f, 20.0f));
+        }
+
+        fontFace.addGlyph(glyph);
+    }
+
+    auto lineFeed = openll::Glyph(nullptr);
+    lineFeed.setIndex('\x0A');
+    fontFace.addGlyph(lineFeed);
+
+    fontFace.setKerning('A', 'V', -2.0f);
+    fontFace.setKerning('T', 'o', -1.5f);
+    fontFace.setKerning('V', 'A', -2.0f);
+}
+
+openll::Label createLabel(openll::FontFace & fontFace, const std::shared_ptr<openll::Text> & text, const bool wordWrap)
+{
+    auto label = openll::Label();
+    label.setText(text);
+    label.setFontFace(fontFace);
+    label.setFontSize(16.0f);
+    label.setWordWrap(wordWrap);
+    label.setLineWidth(200.0f);
+    label.setTransform2D(glm::vec2(-1.0f, 1.0f), glm::uvec2(1920, 1080));
+
+    return label;
+}
+
+std::vector<openll::GlyphVertexCloud::Vertex> typesetVertices(const openll::Label & label)
+{
+    auto vertices = std::vector<openll::GlyphVertexCloud::Vertex>(openll::Typesetter::vertexCount(label));
+
+    auto count = size_t(0);
+    openll::Typesetter::typeset(vertices.data(), vertices.size(), label, &count);
+    vertices.resize(count);
+
+    return vertices;
+}
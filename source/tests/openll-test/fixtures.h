@@ -0,0 +1,52 @@
+
+#pragma once
+
+
+#include <memory>
+#include <vector>
+
+#include <openll/FontFace.h>
+#include <openll/GlyphVertexCloud.h>
+#include <openll/Label.h>
+#include <openll/Text.h>
+
+
+/**
+*  @brief
+*    Configure a synthetic font face without glyph atlas
+*
+*    Contains the printable ASCII characters and a line feed, with
+*    advances that vary by character, and kernings for 'AV', 'To', and 'VA'.
+*
+*  @param[in,out] fontFace
+*    Empty font face
+*/
+void setupFontFace(openll::FontFace & fontFace);
+
+/**
+*  @brief
+*    Create a label of 16pt in a 1920x1080 viewport with a line width of 200pt
+*
+*  @param[in] fontFace
+*    Font face of the label
+*  @param[in] text
+*    Text of the label
+*  @param[in] wordWrap
+*    Wrap words at the line width?
+*
+*  @return
+*    Label
+*/
+openll::Label createLabel(openll::FontFace & fontFace, const std::shared_ptr<openll::Text> & text, bool wordWrap);
+
+/**
+*  @brief
+*    Typeset a label into a vertex list without OpenGL context
+*
+*  @param[in] label
+*    Label to typeset
+*
+*  @return
+*    Vertices of the label
+*/
+std::vector<openll::GlyphVertexCloud::Vertex> typesetVertices(const openll::Label & label);
@@ -0,0 +1,239 @@
+
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/FontLoader.h>
+#include <openll/FontWriter.h>
+#include <openll/Glyph.h>
+#include <openll/GlyphAtlas.h>
+#include <openll/GlyphVertexCloud.h>
+#include <openll/Label.h>
+#include <openll/Text.h>
+#include <openll/Typesetter.h>
+
+#include "fixtures.h"
+
+#ifdef OPENLL_TEST_EMBEDDED_FONT
+#include "embeddedOpenSansR36.h"
+#endif
+
+
+class fontface_test: public testing::Test
+{
+public:
+    fontface_test()
+    {
+        setupFontFace(m_fontFace);
+    }
+
+protected:
+    openll::FontFace m_fontFace;
+};
+
+TEST_F(fontface_test, MissingGlyphResolvesToEmptyGlyph)
+{
+    const auto & fontFace = m_fontFace;
+
+    EXPECT_FALSE(fontFace.hasGlyph(0x4E00));
+    EXPECT_EQ(0.0f, fontFace.glyph(0x4E00).advance());
+    EXPECT_FALSE(fontFace.glyph(0x4E00).depictable());
+    EXPECT_EQ(0.0f, fontFace.kerning('A', 0x4E00));
+}
+
+TEST_F(fontface_test, GenerationChangesOnModification)
+{
+    const auto generation = m_fontFace.generation();
+
+    // Mutable access alone does not modify the glyph
+    m_fontFace.glyph('A');
+    EXPECT_EQ(generation, m_fontFace.generation());
+
+    m_fontFace.glyph('A').setAdvance(20.0f);
+    EXPECT_NE(generation, m_fontFace.generation());
+    EXPECT_EQ(20.0f, m_fontFace.glyphMetrics().advances()[m_fontFace.glyphId('A')]);
+
+    const auto modified = m_fontFace.generation();
+
+    m_fontFace.setKerning('A', 'B', -1.0f);
+    EXPECT_NE(modified, m_fontFace.generation());
+}
+
+#ifdef NDEBUG
+TEST_F(fontface_test, KerningOfMissingGlyphsIsDropped)
+{
+    const auto generation = m_fontFace.generation();
+
+    // Missing glyphs share the empty glyph, so their kerning would apply to all of them
+    m_fontFace.setKerning(0x4E00, 'A', -3.0f);
+    m_fontFace.setKerning('A', 0x4E00, -3.0f);
+
+    EXPECT_EQ(generation, m_fontFace.generation());
+    EXPECT_EQ(0.0f, m_fontFace.kerning(0x4E01, 'A'));
+    EXPECT_EQ(0.0f, m_fontFace.kerning('A', 0x4E00));
+}
+#endif
+
+// Typesets labels of one font face from multiple threads, run with ThreadSanitizer to detect data races
+TEST_F(fontface_test, ConcurrentTypesetting)
+{
+    const auto numThreads = size_t(8);
+    const auto numIterations = size_t(50);
+
+    auto characters = std::u32string();
+    for (auto i = size_t(0); i < 4096; ++i)
+    {
+        characters.push_back(i % 61 == 60 ? U'\n' : i % 7 == 6 ? U' ' : U"AVToabcxyz.,"[i % 12]);
+    }
+
+    // The text is shared as well, so its break index is built concurrently
+    auto text = std::make_shared<openll::Text>();
+    text->setText(characters);
+
+    // References are typeset serially from a separate text
+    auto referenceText = std::make_shared<openll::Text>();
+    referenceText->setText(characters);
+
+    const auto expected = std::vector<std::vector<openll::GlyphVertexCloud::Vertex>>{
+        typesetVertices(createLabel(m_fontFace, referenceText, false)),
+        typesetVertices(createLabel(m_fontFace, referenceText, true))
+    };
+
+    auto results = std::vector<std::vector<std::vector<openll::GlyphVertexCloud::Vertex>>>(numThreads);
+
+    auto threads = std::vector<std::thread>();
+    for (auto t = size_t(0); t < numThreads; ++t)
+    {
+        threads.emplace_back([this, t, &text, &results, numIterations]()
+        {
+            for (auto i = size_t(0); i < numIterations; ++i)
+            {
+                results[t].push_back(typesetVertices(createLabel(m_fontFace, text, (i + t) % 2 == 1)));
+            }
+        });
+    }
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto t = size_t(0); t < numThreads; ++t)
+    {
+        ASSERT_EQ(numIterations, results[t].size());
+
+        for (auto i = size_t(0); i < numIterations; ++i)
+        {
+            const auto & vertices = results[t][i];
+            const auto & reference = expected[(i + t) % 2];
+
+            ASSERT_EQ(reference.size(), vertices.size());
+            EXPECT_EQ(0, std::memcmp(reference.data(), vertices.data(), vertices.size() * sizeof(openll::GlyphVertexCloud::Vertex)));
+        }
+    }
+}
+
+TEST_F(fontface_test, BinaryRoundTrip)
+{
+    const auto filename = std::string("fontface_test.llf");
+
+    auto pixels = std::vector<unsigned char>(8 * 4);
+    for (auto i = size_t(0); i < pixels.size(); ++i)
+    {
+        pixels[i] = static_cast<unsigned char>(i * 7);
+    }
+
+    m_fontFace.setGlyphAtlas(openll::GlyphAtlas(glm::uvec2(8, 4), openll::GlyphAtlas::Format::R8, std::move(pixels)));
+
+    ASSERT_TRUE(openll::FontWriter::write(m_fontFace, filename));
+    const auto loaded = openll::FontLoader::load(filename);
+    std::remove(filename.c_str());
+
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(m_fontFace.ascent(), loaded->ascent());
+    EXPECT_EQ(m_fontFace.descent(), loaded->descent());
+    EXPECT_EQ(m_fontFace.linegap(), loaded->linegap());
+    EXPECT_EQ(m_fontFace.glyphTextureExtent(), loaded->glyphTextureExtent());
+
+    const auto & fontFace = m_fontFace;
+    const auto & loadedFontFace = *loaded;
+
+    for (auto index = size_t(0); index < 128; ++index)
+    {
+        ASSERT_EQ(fontFace.hasGlyph(index), loadedFontFace.hasGlyph(index));
+
+        const auto & glyph = fontFace.glyph(index);
+        const auto & loadedGlyph = loadedFontFace.glyph(index);
+
+        EXPECT_EQ(glyph.advance(), loadedGlyph.advance());
+        EXPECT_EQ(glyph.depictable(), loadedGlyph.depictable());
+        EXPECT_EQ(glyph.subTextureOrigin(), loadedGlyph.subTextureOrigin());
+        EXPECT_EQ(glyph.bearing(), loadedGlyph.bearing());
+
+        for (auto subsequentIndex = size_t(32); subsequentIndex < 127; ++subsequentIndex)
+        {
+            EXPECT_EQ(fontFace.kerning(index, subsequentIndex), loadedFontFace.kerning(index, subsequentIndex));
+        }
+    }
+
+    EXPECT_EQ(fontFace.glyphAtlas().extent(), loadedFontFace.glyphAtlas().extent());
+    ASSERT_EQ(fontFace.glyphAtlas().size(), loadedFontFace.glyphAtlas().size());
+    EXPECT_EQ(0, std::memcmp(fontFace.glyphAtlas().data(), loadedFontFace.glyphAtlas().data(), fontFace.glyphAtlas().size()));
+}
+
+TEST_F(fontface_test, LoadEmbedded)
+{
+    m_fontFace.setGlyphAtlas(openll::GlyphAtlas(glm::uvec2(8, 4), openll::GlyphAtlas::Format::R8, std::vector<unsigned char>(8 * 4, 0x3f)));
+
+    std::ostringstream out(std::ios::out | std::ios::binary);
+    ASSERT_TRUE(openll::FontWriter::write(m_fontFace, out));
+
+    // Embedded fonts are aligned to 16 bytes
+    struct alignas(16) Block { unsigned char bytes[16]; };
+
+    const auto binary = out.str();
+    auto data = std::vector<Block>(binary.size() / sizeof(Block) + 1);
+    std::memcpy(data.data(), binary.data(), binary.size());
+
+    const auto loaded = openll::FontLoader::loadEmbedded(reinterpret_cast<const unsigned char *>(data.data()), binary.size());
+
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(m_fontFace.ascent(), loaded->ascent());
+    EXPECT_EQ(m_fontFace.kerning('A', 'V'), loaded->kerning('A', 'V'));
+
+    // The atlas references the embedded data instead of copying it
+    const auto begin = reinterpret_cast<const unsigned char *>(data.data());
+    EXPECT_TRUE(loaded->glyphAtlas().external());
+    EXPECT_GE(loaded->glyphAtlas().data(), begin);
+    EXPECT_LE(loaded->glyphAtlas().data() + loaded->glyphAtlas().size(), begin + binary.size());
+
+    // Modified kernings are copied, the embedded data remains unchanged
+    const auto embedded = std::vector<Block>(data);
+    loaded->setKerning('A', 'V', -5.0f);
+
+    EXPECT_EQ(-5.0f, loaded->kerning('A', 'V'));
+    EXPECT_EQ(m_fontFace.kerning('T', 'o'), loaded->kerning('T', 'o'));
+    EXPECT_EQ(0, std::memcmp(embedded.data(), data.data(), binary.size()));
+
+    EXPECT_EQ(nullptr, openll::FontLoader::loadEmbedded(reinterpret_cast<const unsigned char *>(data.data()), 16));
+}
+
+#ifdef OPENLL_TEST_EMBEDDED_FONT
+TEST(fontface_embedded_test, DefaultFont)
+{
+    const auto fontFace = embeddedOpenSansR36();
+
+    ASSERT_NE(nullptr, fontFace);
+    EXPECT_TRUE(fontFace->hasGlyph('A'));
+    EXPECT_FALSE(fontFace->glyphAtlas().empty());
+}
+#endif
@@ -0,0 +1,158 @@
+
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/FontLoader.h>
+#include <openll/FontWriter.h>
+#include <openll/Glyph.h>
+#include <openll/GlyphAtlas.h>
+
+#include "BinaryFont.h"
+#include "fixtures.h"
+
+
+TEST(fontloader_test, LoadDescription)
+{
+    // The glyph atlas is read from the file listed in the description (quoted, with a space)
+    const auto atlas = std::string("fontloader test.raw");
+
+    auto pixels = std::vector<unsigned char>(8 * 4);
+    for (auto i = size_t(0); i < pixels.size(); ++i)
+    {
+        pixels[i] = static_cast<unsigned char>(i * 5);
+    }
+
+    const auto file = std::fopen(atlas.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    std::fwrite(pixels.data(), 1, pixels.size(), file);
+    std::fclose(file);
+
+    // Windows line endings, and an announced number of kernings far beyond the size of the description
+    const auto description = std::string(
+        "info face=\"Open Sans\" size=36 bold=0 italic=0 charset=\"\" unicode=1 padding=2,3,4,5 spacing=1,1\r\n"
+        "common lineHeight=50 base=38 scaleW=8 scaleH=4 pages=1 packed=0\r\n"
+        "page id=0 file=\"fontloader test.raw\"\r\n"
+        "chars count=3\r\n"
+        "char id=32 x=0 y=0 width=0 height=0 xoffset=0 yoffset=0 xadvance=9 page=0 chnl=15\r\n"
+        "char id=65 x=0 y=0 width=4 height=4 xoffset=-1.5 yoffset=-2 xadvance=20 page=0 chnl=15\r\n"
+        "char id=86 x=4 y=0 width=4 height=4 xoffset=0.5 yoffset=3 xadvance=19.25 page=0 chnl=15\r\n"
+        "kernings count=4000000000\r\n"
+        "kerning first=65 second=86 amount=-3\r\n"
+        "kerning first=86 second=65 amount=-2.5\r\n");
+
+    const auto fontFace = openll::FontLoader::loadDescription(description.data(), description.data() + description.size(), "./fontloader_test.fnt");
+    std::remove(atlas.c_str());
+
+    ASSERT_NE(nullptr, fontFace);
+    EXPECT_EQ(38.0f, fontFace->ascent());
+    EXPECT_EQ(36.0f, fontFace->size());
+    EXPECT_EQ(14.0f, fontFace->linegap());
+    EXPECT_EQ(glm::uvec2(8, 4), fontFace->glyphTextureExtent());
+
+    EXPECT_EQ(glm::uvec2(8, 4), fontFace->glyphAtlas().extent());
+    ASSERT_EQ(pixels.size(), fontFace->glyphAtlas().size());
+    EXPECT_EQ(0, std::memcmp(pixels.data(), fontFace->glyphAtlas().data(), pixels.size()));
+
+    const auto & constFontFace = *fontFace;
+
+    ASSERT_TRUE(constFontFace.hasGlyph(' '));
+    EXPECT_EQ(9.0f, constFontFace.glyph(' ').advance());
+    EXPECT_FALSE(constFontFace.glyph(' ').depictable());
+
+    // Negative and fractional offsets
+    ASSERT_TRUE(constFontFace.hasGlyph('A'));
+    EXPECT_EQ(20.0f, constFontFace.glyph('A').advance());
+    EXPECT_EQ(glm::vec2(-1.5f, 40.0f), constFontFace.glyph('A').bearing());
+    EXPECT_TRUE(constFontFace.glyph('A').depictable());
+
+    ASSERT_TRUE(constFontFace.hasGlyph('V'));
+    EXPECT_EQ(19.25f, constFontFace.glyph('V').advance());
+    EXPECT_EQ(glm::vec2(0.5f, 35.0f), constFontFace.glyph('V').bearing());
+
+    EXPECT_EQ(-3.0f, constFontFace.kerning('A', 'V'));
+    EXPECT_EQ(-2.5f, constFontFace.kerning('V', 'A'));
+    EXPECT_EQ(0.0f, constFontFace.kerning('A', ' '));
+}
+
+TEST(fontloader_test, LoadAsync)
+{
+    openll::FontFace fontFace;
+    setupFontFace(fontFace);
+
+    const auto filename = std::string("fontloader_test_async.llf");
+
+    auto pixels = std::vector<unsigned char>(8 * 4 * 4, 0x7f);
+    fontFace.setGlyphAtlas(openll::GlyphAtlas(glm::uvec2(8, 4), openll::GlyphAtlas::Format::RGBA8, std::move(pixels)));
+
+    ASSERT_TRUE(openll::FontWriter::write(fontFace, filename));
+
+    // Loading, parsing, and decoding complete without an OpenGL context
+    auto future = openll::FontLoader::loadAsync(filename);
+    const auto loaded = future.get();
+    std::remove(filename.c_str());
+
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(fontFace.ascent(), loaded->ascent());
+    EXPECT_EQ(fontFace.glyphAtlas().format(), loaded->glyphAtlas().format());
+    ASSERT_EQ(fontFace.glyphAtlas().size(), loaded->glyphAtlas().size());
+    EXPECT_EQ(0, std::memcmp(fontFace.glyphAtlas().data(), loaded->glyphAtlas().data(), fontFace.glyphAtlas().size()));
+
+    EXPECT_EQ(nullptr, openll::FontLoader::loadAsync("missing.fnt").get());
+}
+
+TEST(fontloader_test, RejectsMalformedKerningOffsets)
+{
+    openll::FontFace fontFace;
+    setupFontFace(fontFace);
+
+    std::ostringstream stream;
+    ASSERT_TRUE(openll::FontWriter::write(fontFace, stream));
+
+    const auto file = stream.str();
+    auto data = std::vector<unsigned char>(file.cbegin(), file.cend());
+
+    const auto loaded = openll::FontLoader::loadEmbedded(data.data(), data.size());
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(fontFace.kerning('A', 'V'), loaded->kerning('A', 'V'));
+
+    auto header = openll::BinaryFont::Header();
+    std::memcpy(&header, data.data(), sizeof(header));
+    ASSERT_LT(0u, header.kerningCount);
+
+    // Drop the last kerning from its run, so the runs are ordered, but do not cover the kerning table
+    for (auto id = std::uint32_t(0); id < header.glyphCount + 2; ++id)
+    {
+        const auto position = header.kerningOffsetsOffset + id * sizeof(std::uint32_t);
+
+        auto offset = std::uint32_t(0);
+        std::memcpy(&offset, data.data() + position, sizeof(offset));
+
+        if (offset == header.kerningCount)
+        {
+            --offset;
+            std::memcpy(data.data() + position, &offset, sizeof(offset));
+        }
+    }
+
+    EXPECT_EQ(nullptr, openll::FontLoader::loadEmbedded(data.data(), data.size()));
+
+    // Loading from file copies the kerning table instead of referencing it
+    const auto filename = std::string("fontloader_test_malformed.llf");
+
+    const auto output = std::fopen(filename.c_str(), "wb");
+    ASSERT_NE(nullptr, output);
+    std::fwrite(data.data(), 1, data.size(), output);
+    std::fclose(output);
+
+    EXPECT_EQ(nullptr, openll::FontLoader::load(filename));
+    std::remove(filename.c_str());
+}
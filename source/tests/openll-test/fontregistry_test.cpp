@@ -0,0 +1,49 @@
+
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <string>
+
+#include <openll/FontFace.h>
+#include <openll/FontRegistry.h>
+#include <openll/FontWriter.h>
+
+#include "fixtures.h"
+
+
+TEST(fontregistry_test, SharesAndEvictsFontFaces)
+{
+    openll::FontFace fontFace;
+    setupFontFace(fontFace);
+
+    const auto filename = std::string("fontregistry_test.llf");
+
+    ASSERT_TRUE(openll::FontWriter::write(fontFace, filename));
+
+    openll::FontRegistry registry;
+
+    // Different paths to the same file share one font face
+    auto face = registry.get(filename);
+    ASSERT_NE(nullptr, face);
+    EXPECT_EQ(face, registry.get("./" + filename));
+    EXPECT_EQ(1u, registry.size());
+    EXPECT_EQ(face->memoryUsage(), registry.memoryUsage());
+
+    // Referenced font faces are not evicted
+    EXPECT_EQ(0u, registry.collect());
+    registry.setMemoryBudget(0);
+    EXPECT_TRUE(registry.contains(filename));
+
+    // Unreferenced font faces are kept until evicted
+    face.reset();
+    EXPECT_TRUE(registry.contains(filename));
+    EXPECT_EQ(1u, registry.collect());
+    EXPECT_FALSE(registry.contains(filename));
+    EXPECT_EQ(0u, registry.memoryUsage());
+
+    std::remove(filename.c_str());
+
+    // Failed loads are not cached
+    EXPECT_EQ(nullptr, registry.get(filename));
+    EXPECT_EQ(0u, registry.size());
+}
@@ -0,0 +1,62 @@
+
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <glm/gtc/packing.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/GlyphVertexCloud.h>
+#include <openll/Label.h>
+#include <openll/Text.h>
+
+#include "fixtures.h"
+
+
+class glyphvertexcloud_test: public testing::Test
+{
+public:
+    glyphvertexcloud_test()
+    {
+        setupFontFace(m_fontFace);
+    }
+
+protected:
+    openll::FontFace m_fontFace;
+};
+
+TEST_F(glyphvertexcloud_test, PackVertices)
+{
+    auto text = std::make_shared<openll::Text>();
+    text->setText(U"Kerning AVAVA ToTo");
+
+    const auto vertices = typesetVertices(createLabel(m_fontFace, text, false));
+    ASSERT_FALSE(vertices.empty());
+
+    auto packed = std::vector<openll::GlyphVertexCloud::PackedVertex>(vertices.size());
+    openll::GlyphVertexCloud::pack(vertices.data(), vertices.size(), packed.data());
+
+    EXPECT_EQ(40u, sizeof(openll::GlyphVertexCloud::PackedVertex));
+
+    for (auto i = size_t(0); i < vertices.size(); ++i)
+    {
+        const auto & vertex = vertices[i];
+        const auto & packedVertex = packed[i];
+
+        EXPECT_EQ(vertex.origin, packedVertex.origin);
+
+        for (auto c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(vertex.vtan[c], glm::unpackHalf1x16(packedVertex.vtan[c]), 1e-3f * std::abs(vertex.vtan[c]) + 1e-7f);
+            EXPECT_NEAR(vertex.vbitan[c], glm::unpackHalf1x16(packedVertex.vbitan[c]), 1e-3f * std::abs(vertex.vbitan[c]) + 1e-7f);
+        }
+
+        for (auto c = 0; c < 4; ++c)
+        {
+            EXPECT_NEAR(vertex.uvRect[c], glm::unpackUnorm1x16(packedVertex.uvRect[c]), 1.0f / 65535.0f);
+            EXPECT_NEAR(vertex.textColor[c], glm::unpackUnorm1x8(packedVertex.textColor[c]), 1.0f / 255.0f);
+        }
+    }
+}
@@ -0,0 +1,157 @@
+
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/GlyphVertexCloud.h>
+#include <openll/IncrementalTypesetter.h>
+#include <openll/Label.h>
+#include <openll/Text.h>
+#include <openll/Typesetter.h>
+
+#include "fixtures.h"
+
+
+class incrementaltypesetter_test: public testing::Test
+{
+public:
+    using Vertex = openll::GlyphVertexCloud::Vertex;
+    using Positions = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+public:
+    incrementaltypesetter_test()
+    : m_typesetter(m_vertices)
+    {
+        setupFontFace(m_fontFace);
+
+        for (auto i = size_t(0); i < 6; ++i)
+        {
+            auto text = std::make_shared<openll::Text>();
+            text->setText(std::u32string(U"Label AVAVA ToTo").substr(0, 6 + i * 2));
+
+            m_labels.push_back(createLabel(m_fontFace, text, i % 2 == 0));
+            m_labels.back().setTransform2D(glm::vec2(-1.0f, 1.0f - 0.1f * static_cast<float>(i)), glm::uvec2(1920, 1080));
+        }
+    }
+
+    // Compare the maintained vertex list against typesetting all labels from scratch
+    void expectMatchesTypesetter() const
+    {
+        auto expected = std::vector<Vertex>();
+        auto expectedPositions = Positions();
+        openll::Typesetter::typeset(expected, m_labels, false, false, &expectedPositions);
+
+        const auto & positions = m_typesetter.positions();
+        ASSERT_EQ(expectedPositions.size(), positions.size());
+
+        auto used = std::vector<bool>(m_vertices.size(), false);
+
+        for (auto i = size_t(0); i < positions.size(); ++i)
+        {
+            const auto & position = positions[i];
+            const auto & expectedPosition = expectedPositions[i];
+            const auto count = expectedPosition.second - expectedPosition.first;
+
+            ASSERT_EQ(count, position.second - position.first);
+            ASSERT_LE(position.second, m_vertices.size());
+            EXPECT_EQ(0, std::memcmp(expected.data() + expectedPosition.first, m_vertices.data() + position.first, count * sizeof(Vertex)));
+
+            std::fill(used.begin() + position.first, used.begin() + position.second, true);
+        }
+
+        // Vertices of cleared slots are not rendered
+        for (auto i = size_t(0); i < m_vertices.size(); ++i)
+        {
+            if (!used[i])
+            {
+                EXPECT_EQ(glm::vec4(0.0f), m_vertices[i].textColor);
+                EXPECT_EQ(glm::vec4(0.0f), m_vertices[i].uvRect);
+            }
+        }
+    }
+
+protected:
+    openll::FontFace                  m_fontFace;
+    std::vector<openll::Label>        m_labels;
+    std::vector<Vertex>               m_vertices;
+    openll::IncrementalTypesetter     m_typesetter;
+};
+
+TEST_F(incrementaltypesetter_test, TypesetsOnlyChangedLabels)
+{
+    m_typesetter.typeset(m_labels);
+    EXPECT_EQ(6u, m_typesetter.numChangedLabels());
+    expectMatchesTypesetter();
+
+    // Unchanged labels are skipped
+    m_typesetter.typeset(m_labels);
+    EXPECT_EQ(0u, m_typesetter.numChangedLabels());
+    expectMatchesTypesetter();
+
+    // Recolored label is rewritten in place
+    const auto recolored = m_typesetter.positions()[1];
+    m_labels[1].setTextColor(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+
+    m_typesetter.typeset(m_labels);
+    EXPECT_EQ(1u, m_typesetter.numChangedLabels());
+    EXPECT_EQ(recolored, m_typesetter.positions()[1]);
+    expectMatchesTypesetter();
+
+    // Grown label moves to the end of the vertex list
+    const auto size = m_vertices.size();
+    m_labels[2].text()->setText(U"Label AVAVA ToTo grown");
+
+    m_typesetter.typeset(m_labels);
+    EXPECT_EQ(1u, m_typesetter.numChangedLabels());
+    EXPECT_EQ(size, m_typesetter.positions()[2].first);
+    expectMatchesTypesetter();
+
+    // Shrunk label stays in its slot
+    const auto shrunk = m_typesetter.positions()[5];
+    m_labels[5].text()->setText(U"Lab");
+
+    m_typesetter.typeset(m_labels);
+    EXPECT_EQ(1u, m_typesetter.numChangedLabels());
+    EXPECT_EQ(shrunk.first, m_typesetter.positions()[5].first);
+    EXPECT_GT(shrunk.second, m_typesetter.positions()[5].second);
+    expectMatchesTypesetter();
+
+    // Removed label is cleared
+    m_labels.pop_back();
+
+    m_typesetter.typeset(m_labels);
+    EXPECT_EQ(0u, m_typesetter.numChangedLabels());
+    expectMatchesTypesetter();
+}
+
+TEST_F(incrementaltypesetter_test, CompactsUnusedVertices)
+{
+    m_typesetter.typeset(m_labels);
+
+    // Once more than half of the vertices are unused, the vertex list only holds the labels
+    for (auto & label : m_labels)
+    {
+        label.text()->setText(U"L");
+    }
+
+    m_typesetter.typeset(m_labels);
+    EXPECT_EQ(6u, m_typesetter.numChangedLabels());
+    EXPECT_EQ(6u, m_vertices.size());
+    expectMatchesTypesetter();
+
+    // Slots have shrunk to their labels, so growing labels move them
+    m_labels[0].text()->setText(U"Label");
+
+    m_typesetter.typeset(m_labels);
+    EXPECT_EQ(6u, m_typesetter.positions()[0].first);
+    expectMatchesTypesetter();
+}
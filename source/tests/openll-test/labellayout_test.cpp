@@ -0,0 +1,157 @@
+
+#include <gmock/gmock.h>
+
+#include <memory>
+
+#include <glm/vec2.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/Glyph.h>
+#include <openll/Label.h>
+#include <openll/LabelLayout.h>
+#include <openll/LineBreakClass.h>
+#include <openll/LineBreakTable.h>
+#include <openll/Text.h>
+#include <openll/Typesetter.h>
+
+#include "fixtures.h"
+
+
+class labellayout_test: public testing::Test
+{
+public:
+    labellayout_test()
+    : m_text(std::make_shared<openll::Text>())
+    {
+        setupFontFace(m_fontFace);
+        m_text->setText(U"Kerning AVAVA ToTo");
+    }
+
+protected:
+    openll::FontFace              m_fontFace;
+    std::shared_ptr<openll::Text> m_text;
+};
+
+TEST_F(labellayout_test, EmptyLayoutIsInvalid)
+{
+    const auto label = createLabel(m_fontFace, m_text, false);
+
+    EXPECT_FALSE(openll::LabelLayout().isValid(label));
+}
+
+TEST_F(labellayout_test, InvalidatedByKerningChange)
+{
+    const auto label = createLabel(m_fontFace, m_text, false);
+
+    auto layout = openll::LabelLayout();
+    openll::Typesetter::layout(layout, label);
+    ASSERT_TRUE(layout.isValid(label));
+
+    const auto extent = layout.extent();
+
+    m_fontFace.setKerning('A', 'V', -4.0f);
+    EXPECT_FALSE(layout.isValid(label));
+
+    // The new layout reflects the changed kerning
+    openll::Typesetter::layout(layout, label);
+    EXPECT_TRUE(layout.isValid(label));
+    EXPECT_LT(layout.extent().x, extent.x);
+}
+
+TEST_F(labellayout_test, InvalidatedByLineBreakTableChange)
+{
+    auto lineBreakTable = openll::LineBreakTable();
+
+    auto label = createLabel(m_fontFace, m_text, true);
+    label.setLineBreakTable(lineBreakTable);
+
+    auto layout = openll::LabelLayout();
+    openll::Typesetter::layout(layout, label);
+    ASSERT_TRUE(layout.isValid(label));
+
+    lineBreakTable.setLineBreakClass(U'A', openll::LineBreakClass::Ideographic);
+    EXPECT_FALSE(layout.isValid(label));
+}
+
+TEST_F(labellayout_test, InvalidatedByTextChange)
+{
+    const auto label = createLabel(m_fontFace, m_text, false);
+
+    auto layout = openll::LabelLayout();
+    openll::Typesetter::layout(layout, label);
+    ASSERT_TRUE(layout.isValid(label));
+
+    m_text->setText(U"Another text");
+    EXPECT_FALSE(layout.isValid(label));
+}
+
+TEST_F(labellayout_test, WrapsIdeographs)
+{
+    // Ideographs allow breaks before and after them, even within words
+    for (const auto character : { U'\u4E00', U'\u4E8C', U'\u4E09' })
+    {
+        auto glyph = openll::Glyph(nullptr);
+        glyph.setIndex(character);
+        glyph.setAdvance(30.0f);
+        glyph.setSubTextureExtent(glm::vec2(1.0f / 16.0f, 1.0f / 8.0f));
+        glyph.setExtent(glm::vec2(28.0f, 28.0f));
+        m_fontFace.addGlyph(glyph);
+    }
+
+    m_text->setText(U"\u4E00\u4E8C\u4E09word");
+
+    // The line width of 60 corresponds to 135 in font units (font size 16, font face size 36)
+    auto label = createLabel(m_fontFace, m_text, true);
+    label.setLineWidth(60.0f);
+
+    auto layout = openll::LabelLayout();
+    openll::Typesetter::layout(layout, label);
+
+    ASSERT_EQ(2u, layout.lineExtents().size());
+    EXPECT_FLOAT_EQ(90.0f, layout.lineExtents()[0].x);
+    EXPECT_FLOAT_EQ(50.0f, layout.lineExtents()[1].x);
+
+    // Without ideographic breaks, the word is broken behind its last fitting glyph
+    auto lineBreakTable = openll::LineBreakTable();
+    for (const auto character : { U'\u4E00', U'\u4E8C', U'\u4E09' })
+    {
+        lineBreakTable.setLineBreakClass(character, openll::LineBreakClass::Other);
+    }
+
+    label.setLineBreakTable(lineBreakTable);
+    openll::Typesetter::layout(layout, label);
+
+    ASSERT_EQ(2u, layout.lineExtents().size());
+    EXPECT_FLOAT_EQ(128.0f, layout.lineExtents()[0].x);
+    EXPECT_FLOAT_EQ(12.0f, layout.lineExtents()[1].x);
+}
+
+TEST_F(labellayout_test, KeepsNoBreakCharactersTogether)
+{
+    auto noBreakSpace = openll::Glyph(nullptr);
+    noBreakSpace.setIndex(U'\u00A0');
+    noBreakSpace.setAdvance(14.0f);
+    m_fontFace.addGlyph(noBreakSpace);
+
+    m_text->setText(U"ab cd\u00A0ef gh");
+
+    // The line width of 40 corresponds to 90 in font units
+    auto label = createLabel(m_fontFace, m_text, true);
+    label.setLineWidth(40.0f);
+
+    auto layout = openll::LabelLayout();
+    openll::Typesetter::layout(layout, label);
+
+    ASSERT_EQ(3u, layout.lineExtents().size());
+    EXPECT_FLOAT_EQ(26.0f, layout.lineExtents()[0].x);
+    EXPECT_FLOAT_EQ(64.0f, layout.lineExtents()[1].x);
+    EXPECT_FLOAT_EQ(31.0f, layout.lineExtents()[2].x);
+
+    // A regular space allows to break between the words
+    m_text->setText(U"ab cd ef gh");
+    openll::Typesetter::layout(layout, label);
+
+    ASSERT_EQ(2u, layout.lineExtents().size());
+    EXPECT_FLOAT_EQ(63.0f, layout.lineExtents()[0].x);
+    EXPECT_FLOAT_EQ(72.0f, layout.lineExtents()[1].x);
+}
@@ -0,0 +1,121 @@
+
+#include <gmock/gmock.h>
+
+#include <openll/LineBreakClass.h>
+#include <openll/LineBreakTable.h>
+
+
+using openll::LineBreakClass;
+using openll::LineBreakTable;
+
+
+TEST(linebreaktable_test, ClassifiesASCII)
+{
+    const auto & table = LineBreakTable::defaultTable();
+
+    EXPECT_EQ(LineBreakClass::Other,      table.lineBreakClass(U'a'));
+    EXPECT_EQ(LineBreakClass::Other,      table.lineBreakClass(U'Z'));
+    EXPECT_EQ(LineBreakClass::Other,      table.lineBreakClass(U'0'));
+    EXPECT_EQ(LineBreakClass::Space,      table.lineBreakClass(U' '));
+    EXPECT_EQ(LineBreakClass::Space,      table.lineBreakClass(U'\t'));
+    EXPECT_EQ(LineBreakClass::Hyphen,     table.lineBreakClass(U'-'));
+    EXPECT_EQ(LineBreakClass::BreakAfter, table.lineBreakClass(U','));
+    EXPECT_EQ(LineBreakClass::BreakAfter, table.lineBreakClass(U'.'));
+    EXPECT_EQ(LineBreakClass::BreakAfter, table.lineBreakClass(U'('));
+    EXPECT_EQ(LineBreakClass::BreakAfter, table.lineBreakClass(U']'));
+    EXPECT_EQ(LineBreakClass::NoBreak,    table.lineBreakClass(U'\u00A0'));
+}
+
+TEST(linebreaktable_test, ClassifiesCJK)
+{
+    const auto & table = LineBreakTable::defaultTable();
+
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u4E00')); // CJK unified ideographs
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u9FA5'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u3042')); // Hiragana
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u30A2')); // Katakana
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\uAC00')); // Hangul
+    EXPECT_EQ(LineBreakClass::Space,       table.lineBreakClass(U'\u3000'));
+    EXPECT_EQ(LineBreakClass::BreakAfter,  table.lineBreakClass(U'\u3001'));
+    EXPECT_EQ(LineBreakClass::BreakAfter,  table.lineBreakClass(U'\u3002'));
+}
+
+// Blocks in which ranges of different classes begin or end
+TEST(linebreaktable_test, ClassifiesMixedBlocks)
+{
+    const auto & table = LineBreakTable::defaultTable();
+
+    EXPECT_EQ(LineBreakClass::Space,       table.lineBreakClass(U'\u200B'));
+    EXPECT_EQ(LineBreakClass::Hyphen,      table.lineBreakClass(U'\u2010'));
+    EXPECT_EQ(LineBreakClass::NoBreak,     table.lineBreakClass(U'\u2011'));
+    EXPECT_EQ(LineBreakClass::NoBreak,     table.lineBreakClass(U'\u2060'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\u2E7F'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u2E80'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u4DBF'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\u4DC0'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\uA4CF'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\uA4D0'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\uD7A3'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\uD7B0'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\uFE2F'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\uFE30'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\uFE50'));
+    EXPECT_EQ(LineBreakClass::NoBreak,     table.lineBreakClass(U'\uFEFF'));
+    EXPECT_EQ(LineBreakClass::BreakAfter,  table.lineBreakClass(U'\uFF0C'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\uFF0D'));
+    EXPECT_EQ(LineBreakClass::BreakAfter,  table.lineBreakClass(U'\uFF61'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\uFFE6'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\uFFE7'));
+
+    // Blocks with uniform classes
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\u0416'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u5000'));
+}
+
+TEST(linebreaktable_test, ClassifiesAstralCodePoints)
+{
+    const auto & table = LineBreakTable::defaultTable();
+
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\U00010000'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\U0001F600')); // Emoji
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\U0001FB00'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\U00020000')); // CJK extension B
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\U0003FFFF'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\U00040000'));
+    EXPECT_EQ(LineBreakClass::Other,       table.lineBreakClass(U'\U0010FFFF'));
+}
+
+TEST(linebreaktable_test, ReclassifiesWithoutAffectingSharedBlocks)
+{
+    auto table = LineBreakTable();
+    const auto generation = table.generation();
+
+    // The ideographs share a single block of the default table
+    table.setLineBreakClass(U'\u5000', LineBreakClass::NoBreak);
+
+    EXPECT_NE(generation, table.generation());
+    EXPECT_EQ(LineBreakClass::NoBreak,     table.lineBreakClass(U'\u5000'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u5001'));
+    EXPECT_EQ(LineBreakClass::Ideographic, table.lineBreakClass(U'\u6000'));
+    EXPECT_EQ(LineBreakClass::Ideographic, LineBreakTable::defaultTable().lineBreakClass(U'\u5000'));
+
+    // Copies keep the modified classes
+    const auto copy = table;
+    EXPECT_EQ(LineBreakClass::NoBreak, copy.lineBreakClass(U'\u5000'));
+    EXPECT_NE(table.generation(), copy.generation());
+}
+
+TEST(linebreaktable_test, BreakOpportunities)
+{
+    EXPECT_TRUE(LineBreakTable::isBreakOpportunity(LineBreakClass::Space, LineBreakClass::Other));
+    EXPECT_TRUE(LineBreakTable::isBreakOpportunity(LineBreakClass::Hyphen, LineBreakClass::Other));
+    EXPECT_TRUE(LineBreakTable::isBreakOpportunity(LineBreakClass::Ideographic, LineBreakClass::Ideographic));
+    EXPECT_TRUE(LineBreakTable::isBreakOpportunity(LineBreakClass::Other, LineBreakClass::Ideographic));
+    EXPECT_TRUE(LineBreakTable::isBreakOpportunity(LineBreakClass::Ideographic, LineBreakClass::Other));
+
+    EXPECT_FALSE(LineBreakTable::isBreakOpportunity(LineBreakClass::Other, LineBreakClass::Other));
+    EXPECT_FALSE(LineBreakTable::isBreakOpportunity(LineBreakClass::Other, LineBreakClass::Space));
+    EXPECT_FALSE(LineBreakTable::isBreakOpportunity(LineBreakClass::Ideographic, LineBreakClass::BreakAfter));
+    EXPECT_FALSE(LineBreakTable::isBreakOpportunity(LineBreakClass::NoBreak, LineBreakClass::Ideographic));
+    EXPECT_FALSE(LineBreakTable::isBreakOpportunity(LineBreakClass::Space, LineBreakClass::NoBreak));
+}
@@ -0,0 +1,61 @@
+
+#include <gmock/gmock.h>
+
+#include "StreamSegments.h"
+
+
+TEST(streamsegments_test, WritesSegmentsInTurn)
+{
+    auto segments = openll::StreamSegments(3, 100);
+
+    EXPECT_EQ(3u, segments.numSegments());
+    EXPECT_EQ(100u, segments.capacity());
+    EXPECT_EQ(0u, segments.size());
+
+    // The first segment is written first
+    EXPECT_EQ(0u, segments.begin());
+    EXPECT_EQ(0u, segments.offset());
+    segments.end(40);
+    EXPECT_EQ(40u, segments.size());
+
+    EXPECT_EQ(1u, segments.begin());
+    EXPECT_EQ(1u, segments.segment());
+    EXPECT_EQ(100u, segments.offset());
+
+    // Nothing is drawn from a segment that is being written
+    EXPECT_EQ(0u, segments.size());
+    segments.end(100);
+    EXPECT_EQ(100u, segments.size());
+
+    EXPECT_EQ(2u, segments.begin());
+    EXPECT_EQ(200u, segments.offset());
+    segments.end(0);
+    EXPECT_EQ(0u, segments.size());
+
+    // Segments are reused after the last one
+    EXPECT_EQ(0u, segments.begin());
+    EXPECT_EQ(0u, segments.offset());
+    segments.end(7);
+    EXPECT_EQ(7u, segments.size());
+}
+
+TEST(streamsegments_test, DefaultIsNotStreaming)
+{
+    const auto segments = openll::StreamSegments();
+
+    EXPECT_EQ(0u, segments.numSegments());
+    EXPECT_EQ(0u, segments.capacity());
+    EXPECT_EQ(0u, segments.size());
+}
+
+#ifdef NDEBUG
+TEST(streamsegments_test, CountIsClampedToCapacity)
+{
+    auto segments = openll::StreamSegments(2, 10);
+
+    segments.begin();
+    segments.end(25);
+
+    EXPECT_EQ(10u, segments.size());
+}
+#endif
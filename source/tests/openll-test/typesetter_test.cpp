@@ -0,0 +1,340 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/Glyph.h>
+#include <openll/GlyphMetricsTable.h>
+#include <openll/GlyphVertexCloud.h>
+#include <openll/Label.h>
+#include <openll/LabelLayout.h>
+#include <openll/Text.h>
+#include <openll/Typesetter.h>
+
+#include "fixtures.h"
+
+
+class typesetter_test: public testing::Test
+{
+public:
+    typesetter_test()
+    {
+        setupFontFace(m_fontFace);
+    }
+
+protected:
+    openll::FontFace m_fontFace;
+};
+
+TEST_F(typesetter_test, ParallelMatchesSerial)
+{
+    // Labels of varying length, so the chunks of the parallel mode differ in size
+    auto labels = std::vector<openll::Label>();
+    for (auto i = size_t(0); i < 200; ++i)
+    {
+        auto characters = std::u32string();
+        for (auto c = size_t(0); c < 1 + (i * 37) % 300; ++c)
+        {
+            characters.push_back(c % 41 == 40 ? U'\n' : c % 6 == 5 ? U' ' : U"AVToabcxyz.,"[(i + c) % 12]);
+        }
+
+        auto text = std::make_shared<openll::Text>();
+        text->setText(characters);
+
+        labels.push_back(createLabel(m_fontFace, text, i % 2 == 0));
+        labels.back().setTransform2D(glm::vec2(-1.0f + 0.01f * static_cast<float>(i), 1.0f), glm::uvec2(1920, 1080));
+    }
+
+    for (const auto optimize : { false, true })
+    {
+        using Positions = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+        auto serial = std::vector<openll::GlyphVertexCloud::Vertex>();
+        auto serialPositions = Positions();
+        const auto serialExtent = openll::Typesetter::typeset(serial, labels, optimize, false, &serialPositions, false);
+
+        auto parallel = std::vector<openll::GlyphVertexCloud::Vertex>();
+        auto parallelPositions = Positions();
+        const auto parallelExtent = openll::Typesetter::typeset(parallel, labels, optimize, false, &parallelPositions, true);
+
+        ASSERT_FALSE(serial.empty());
+        ASSERT_EQ(serial.size(), parallel.size());
+        EXPECT_EQ(0, std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(openll::GlyphVertexCloud::Vertex)));
+        EXPECT_EQ(serialPositions, parallelPositions);
+        EXPECT_EQ(serialExtent, parallelExtent);
+    }
+}
+
+// Covers the SIMD kernels of the vertex transform (batches of 4 and 8 glyphs) and their remainders
+TEST_F(typesetter_test, TransformMatchesReference)
+{
+    // Every matrix element differs, so mixed up components produce different results
+    auto transform = glm::mat4();
+    for (auto c = 0; c < 4; ++c)
+    {
+        for (auto r = 0; r < 4; ++r)
+        {
+            transform[c][r] = 0.1f * static_cast<float>(c * 4 + r + 1) - (r == 3 ? 0.0f : 0.35f);
+        }
+    }
+
+    const auto textColor = glm::vec4(0.25f, 0.5f, 0.75f, 1.0f);
+
+    for (const auto count : { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 17u })
+    {
+        // Glyphs differ in advance and line, so each vertex has a distinct origin
+        auto characters = std::u32string();
+        for (auto i = 0u; i < count; ++i)
+        {
+            characters.push_back(U"AVToabcxyz"[i % 10]);
+
+            if (i % 5 == 4)
+            {
+                characters.push_back(U'\n');
+            }
+        }
+
+        auto text = std::make_shared<openll::Text>();
+        text->setText(characters);
+
+        auto label = createLabel(m_fontFace, text, false);
+        label.setTransform(transform);
+        label.setTextColor(textColor);
+
+        auto layout = openll::LabelLayout();
+        openll::Typesetter::layout(layout, label);
+
+        const auto & reference = layout.vertices();
+        ASSERT_EQ(count, reference.size());
+
+        auto vertices = std::vector<openll::GlyphVertexCloud::Vertex>(count + 1);
+        openll::Typesetter::typeset(vertices.data(), vertices.size(), layout, label);
+
+        for (auto i = size_t(0); i < count; ++i)
+        {
+            const auto & v = reference[i];
+
+            const auto origin = transform * glm::vec4(v.origin, 1.0f);
+            const auto vtan   = transform * glm::vec4(v.vtan, 0.0f);
+            const auto vbitan = transform * glm::vec4(v.vbitan, 0.0f);
+
+            for (auto c = 0; c < 3; ++c)
+            {
+                EXPECT_FLOAT_EQ(origin[c], vertices[i].origin[c]) << "count " << count << ", vertex " << i;
+                EXPECT_FLOAT_EQ(vtan[c], vertices[i].vtan[c]) << "count " << count << ", vertex " << i;
+                EXPECT_FLOAT_EQ(vbitan[c], vertices[i].vbitan[c]) << "count " << count << ", vertex " << i;
+            }
+
+            EXPECT_EQ(v.uvRect, vertices[i].uvRect);
+            EXPECT_EQ(textColor, vertices[i].textColor);
+        }
+    }
+}
+
+TEST_F(typesetter_test, OptimizeSortsStablyByGlyphIndex)
+{
+    // Glyphs beyond 2047, so the radix sort needs more than one pass
+    const auto ideographs = std::u32string(U"\u0800\u3042\u4E00\u4E01\U0001F600");
+
+    for (auto i = size_t(0); i < ideographs.size(); ++i)
+    {
+        auto glyph = openll::Glyph(nullptr);
+        glyph.setIndex(ideographs[i]);
+        glyph.setAdvance(24.0f);
+        glyph.setSubTextureOrigin(glm::vec2(static_cast<float>(i) / 16.0f, 1.0f));
+        glyph.setSubTextureExtent(glm::vec2(1.0f / 16.0f, 1.0f / 8.0f));
+        glyph.setExtent(glm::vec2(24.0f, 24.0f));
+        glyph.setBearing(glm::vec2(0.0f, 20.0f));
+
+        m_fontFace.addGlyph(glyph);
+    }
+
+    // Each glyph has a distinct subtexture, which identifies the glyph of a vertex
+    const auto & metrics = static_cast<const openll::FontFace &>(m_fontFace).glyphMetrics();
+
+    auto glyphIndices = std::map<std::pair<float, float>, std::uint32_t>();
+    for (auto id = size_t(0); id < metrics.size(); ++id)
+    {
+        const auto & rectangle = metrics.subtextureRectangles()[id];
+
+        if (metrics.depictables()[id])
+        {
+            ASSERT_TRUE(glyphIndices.emplace(std::make_pair(rectangle.x, rectangle.y), metrics.indices()[id]).second);
+        }
+    }
+
+    const auto glyphIndex = [&glyphIndices](const openll::GlyphVertexCloud::Vertex & vertex)
+    {
+        return glyphIndices.at(std::make_pair(vertex.uvRect.x, vertex.uvRect.y));
+    };
+
+    // Repeated glyphs in several labels, so the order among equal glyph indices matters
+    auto labels = std::vector<openll::Label>();
+    for (auto i = size_t(0); i < 12; ++i)
+    {
+        auto characters = std::u32string();
+        for (auto c = size_t(0); c < 20 + i * 7; ++c)
+        {
+            characters.push_back(c % 9 == 8 ? U' ' : c % 3 == 0 ? ideographs[(i + c) % ideographs.size()] : U"AVTo\u3042"[(i * c) % 5]);
+        }
+
+        auto text = std::make_shared<openll::Text>();
+        text->setText(characters);
+
+        labels.push_back(createLabel(m_fontFace, text, i % 2 == 0));
+        labels.back().setTransform2D(glm::vec2(-1.0f, 1.0f - 0.05f * static_cast<float>(i)), glm::uvec2(1920, 1080));
+    }
+
+    auto expected = std::vector<openll::GlyphVertexCloud::Vertex>();
+    openll::Typesetter::typeset(expected, labels, false);
+
+    std::stable_sort(expected.begin(), expected.end(), [&glyphIndex](const openll::GlyphVertexCloud::Vertex & lhs, const openll::GlyphVertexCloud::Vertex & rhs)
+    {
+        return glyphIndex(lhs) < glyphIndex(rhs);
+    });
+
+    auto optimized = std::vector<openll::GlyphVertexCloud::Vertex>();
+    openll::Typesetter::typeset(optimized, labels, true);
+
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected.size(), optimized.size());
+    EXPECT_EQ(0, std::memcmp(expected.data(), optimized.data(), expected.size() * sizeof(openll::GlyphVertexCloud::Vertex)));
+    EXPECT_LT(glyphIndex(optimized.front()), 2048u);
+    EXPECT_EQ(0x1F600u, glyphIndex(optimized.back()));
+}
+
+TEST_F(typesetter_test, BufferMatchesVector)
+{
+    auto text = std::make_shared<openll::Text>();
+    text->setText(U"AVAVA ToTo, wrapped at the line width.\nabc xyz");
+
+    for (const auto wordWrap : { false, true })
+    {
+        auto label = createLabel(m_fontFace, text, wordWrap);
+
+        for (const auto optimize : { false, true })
+        {
+            auto expected = std::vector<openll::GlyphVertexCloud::Vertex>();
+            const auto expectedExtent = openll::Typesetter::typeset(expected, std::vector<openll::Label>{ label }, optimize);
+
+            // The text length is sufficient without counting the vertices
+            auto vertices = std::vector<openll::GlyphVertexCloud::Vertex>(text->text().size());
+            auto count = size_t(0);
+            const auto extent = openll::Typesetter::typeset(vertices.data(), vertices.size(), label, &count, optimize);
+
+            ASSERT_FALSE(expected.empty());
+            ASSERT_EQ(expected.size(), count);
+            EXPECT_EQ(openll::Typesetter::vertexCount(label), count);
+            EXPECT_EQ(0, std::memcmp(expected.data(), vertices.data(), count * sizeof(openll::GlyphVertexCloud::Vertex)));
+            EXPECT_EQ(expectedExtent, extent);
+        }
+    }
+}
+
+TEST_F(typesetter_test, BufferWithInsufficientCapacity)
+{
+    auto text = std::make_shared<openll::Text>();
+    text->setText(U"AVAVA ToTo");
+
+    const auto label = createLabel(m_fontFace, text, false);
+    const auto required = openll::Typesetter::vertexCount(label);
+    ASSERT_EQ(9u, required);
+
+    // Vertices behind the capacity must stay untouched
+    auto guard = openll::GlyphVertexCloud::Vertex();
+    guard.origin = glm::vec3(-1.0f, -2.0f, -3.0f);
+    guard.vtan = glm::vec3(-4.0f, -5.0f, -6.0f);
+    guard.vbitan = glm::vec3(-7.0f, -8.0f, -9.0f);
+    guard.uvRect = glm::vec4(-1.0f);
+    guard.textColor = glm::vec4(-2.0f);
+
+    auto vertices = std::vector<openll::GlyphVertexCloud::Vertex>(required, guard);
+    auto count = size_t(0);
+    auto extent = glm::vec2(1.0f, 1.0f);
+
+    // Debug builds assert on the insufficient capacity
+    EXPECT_DEBUG_DEATH(extent = openll::Typesetter::typeset(vertices.data(), required - 1, label, &count), "");
+
+#ifdef NDEBUG
+    EXPECT_EQ(glm::vec2(0.0f, 0.0f), extent);
+#endif
+    EXPECT_EQ(0u, count);
+
+    for (const auto & vertex : vertices)
+    {
+        EXPECT_EQ(0, std::memcmp(&guard, &vertex, sizeof(guard)));
+    }
+}
+
+TEST_F(typesetter_test, SinkReceivesVerticesInOrder)
+{
+    auto text = std::make_shared<openll::Text>();
+    text->setText(U"AVAVA ToTo, wrapped at the line width.\n\nabc xyz");
+
+    for (const auto wordWrap : { false, true })
+    {
+        auto label = createLabel(m_fontFace, text, wordWrap);
+
+        auto received = std::vector<openll::GlyphVertexCloud::Vertex>();
+        auto numCalls = size_t(0);
+
+        const auto sink = [&received, &numCalls](const openll::GlyphVertexCloud::Vertex * vertices, std::size_t count)
+        {
+            EXPECT_LT(0u, count);
+
+            received.insert(received.end(), vertices, vertices + count);
+            ++numCalls;
+        };
+
+        const auto extent = openll::Typesetter::typeset(sink, label);
+
+        auto expected = std::vector<openll::GlyphVertexCloud::Vertex>();
+        const auto expectedExtent = openll::Typesetter::typeset(expected, std::vector<openll::Label>{ label });
+
+        // One call per line with depictable glyphs, the empty line is skipped
+        EXPECT_LE(2u, numCalls);
+        ASSERT_EQ(openll::Typesetter::vertexCount(label), received.size());
+        ASSERT_EQ(expected.size(), received.size());
+        EXPECT_EQ(0, std::memcmp(expected.data(), received.data(), expected.size() * sizeof(openll::GlyphVertexCloud::Vertex)));
+        EXPECT_EQ(expectedExtent, extent);
+    }
+}
+
+TEST_F(typesetter_test, LayoutIntoBufferMatchesVector)
+{
+    auto text = std::make_shared<openll::Text>();
+    text->setText(U"AVAVA ToTo, wrapped at the line width.\nabc xyz");
+
+    auto label = createLabel(m_fontFace, text, true);
+
+    auto layout = openll::LabelLayout();
+    openll::Typesetter::layout(layout, label);
+
+    // Transformation and text color are applied without re-layouting
+    label.setTransform2D(glm::vec2(-0.5f, 0.25f), glm::uvec2(1920, 1080));
+    label.setTextColor(glm::vec4(0.25f, 0.5f, 0.75f, 1.0f));
+    ASSERT_TRUE(layout.isValid(label));
+
+    auto expected = std::vector<openll::GlyphVertexCloud::Vertex>();
+    const auto expectedExtent = openll::Typesetter::typeset(expected, std::vector<openll::Label>{ label });
+
+    auto vertices = std::vector<openll::GlyphVertexCloud::Vertex>(layout.vertices().size());
+    const auto extent = openll::Typesetter::typeset(vertices.data(), vertices.size(), layout, label);
+
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected.size(), vertices.size());
+    EXPECT_EQ(0, std::memcmp(expected.data(), vertices.data(), expected.size() * sizeof(openll::GlyphVertexCloud::Vertex)));
+    EXPECT_EQ(expectedExtent, extent);
+}
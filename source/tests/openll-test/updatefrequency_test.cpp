@@ -0,0 +1,78 @@
+
+#include <gmock/gmock.h>
+
+#include "UpdateFrequency.h"
+
+
+TEST(updatefrequency_test, UpdatesInMostRecentFramesAreFrequent)
+{
+    auto frequency = openll::UpdateFrequency(8, 16);
+
+    // Every other frame is updated, so 8 updates span 15 frames
+    for (auto frame = 0; frame < 14; ++frame)
+    {
+        if (frame % 2 == 0)
+        {
+            frequency.update();
+        }
+
+        frequency.draw();
+        EXPECT_FALSE(frequency.isFrequent()) << "frame " << frame;
+    }
+
+    frequency.update();
+    EXPECT_TRUE(frequency.isFrequent());
+
+    // Frequent updates end once the oldest of them leaves the window
+    frequency.draw();
+    EXPECT_TRUE(frequency.isFrequent());
+
+    frequency.draw();
+    EXPECT_FALSE(frequency.isFrequent());
+}
+
+TEST(updatefrequency_test, UpdatesWithinFrameCountOnce)
+{
+    auto frequency = openll::UpdateFrequency(8, 16);
+
+    // Building up a buffer before it is drawn
+    for (auto i = 0; i < 100; ++i)
+    {
+        frequency.update();
+    }
+
+    EXPECT_FALSE(frequency.isFrequent());
+
+    frequency.draw();
+    frequency.update();
+    frequency.update();
+
+    EXPECT_FALSE(frequency.isFrequent());
+}
+
+TEST(updatefrequency_test, SparseUpdatesAreNeverFrequent)
+{
+    auto frequency = openll::UpdateFrequency(8, 16);
+
+    // Updates every third frame exceed any number of updates over a long lifetime
+    for (auto frame = 0; frame < 1000; ++frame)
+    {
+        if (frame % 3 == 0)
+        {
+            frequency.update();
+        }
+
+        EXPECT_FALSE(frequency.isFrequent()) << "frame " << frame;
+
+        frequency.draw();
+    }
+
+    // Consecutive updates become frequent as soon as they fill the window
+    for (auto frame = 0; frame < 8; ++frame)
+    {
+        frequency.draw();
+        frequency.update();
+    }
+
+    EXPECT_TRUE(frequency.isFrequent());
+}
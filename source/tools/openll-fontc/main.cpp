@@ -0,0 +1,116 @@
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <openll/FontFace.h>
+#include <openll/FontLoader.h>
+#include <openll/FontWriter.h>
+
+
+using namespace openll;
+
+
+namespace
+{
+
+
+bool endsWith(const std::string & str, const std::string & suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string filenameOf(const std::string & path)
+{
+    const auto slash = path.find_last_of("/\\");
+
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// Write a translation unit that embeds the binary font and a header that declares its factory function
+bool writeSource(const std::string & binary, const std::string & filename, const std::string & function, const std::string & input)
+{
+    const auto headerFilename = filename.substr(0, filename.size() - 4) + ".h";
+    const auto headerName = filenameOf(headerFilename);
+
+    std::ofstream header(headerFilename, std::ios::out | std::ios::trunc);
+    header << "\n// Generated by openll-fontc from " << input << ", do not edit\n\n"
+        << "#pragma once\n\n\n"
+        << "#include <memory>\n\n"
+        << "#include <openll/FontFace.h>\n\n\n"
+        << "/**\n*  @brief\n*    Load the embedded font face without file access\n*\n"
+        << "*  @return\n*    The loaded font face, 'nullptr' if it was compiled for another byte order\n*/\n"
+        << "std::unique_ptr<openll::FontFace> " << function << "();\n";
+
+    std::ofstream source(filename, std::ios::out | std::ios::trunc);
+    source << "\n// Generated by openll-fontc from " << input << ", do not edit\n\n"
+        << "#include \"" << headerName << "\"\n\n"
+        << "#include <openll/FontLoader.h>\n\n\n"
+        << "namespace\n{\n\n\n"
+        << "// Binary font file (.llf), sections are aligned relative to its start\n"
+        << "alignas(16) constexpr unsigned char data[] =\n{";
+
+    static const char digits[] = "0123456789abcdef";
+
+    for (auto i = std::size_t(0); i < binary.size(); ++i)
+    {
+        const auto byte = static_cast<unsigned char>(binary[i]);
+
+        source << (i % 16 == 0 ? "\n    " : " ") << "0x" << digits[byte >> 4] << digits[byte & 0xf] << ",";
+    }
+
+    source << "\n};\n\n\n"
+        << "} // namespace\n\n\n"
+        << "std::unique_ptr<openll::FontFace> " << function << "()\n{\n"
+        << "    return openll::FontLoader::loadEmbedded(data, sizeof(data));\n"
+        << "}\n";
+
+    return static_cast<bool>(header) && static_cast<bool>(source);
+}
+
+
+} // namespace
+
+
+int main(int argc, char * argv[])
+{
+    const auto embed = argc == 4 && endsWith(argv[2], ".cpp");
+
+    if (argc != 3 && !embed)
+    {
+        std::cerr << "Usage: openll-fontc <input.fnt> <output.llf>" << std::endl;
+        std::cerr << "       openll-fontc <input.fnt> <output.cpp> <function>" << std::endl;
+        std::cerr << "Compile a font description (.fnt) and its glyph atlas (.raw) into a binary font file," << std::endl;
+        std::cerr << "or into a source file that embeds the binary font and defines a function to load it." << std::endl;
+        return 1;
+    }
+
+    const auto fontFace = FontLoader::load(argv[1]);
+    if (!fontFace)
+    {
+        std::cerr << "Could not load font '" << argv[1] << "'" << std::endl;
+        return 1;
+    }
+
+    if (embed)
+    {
+        std::ostringstream binary(std::ios::out | std::ios::binary);
+
+        if (!FontWriter::write(*fontFace, binary) || !writeSource(binary.str(), argv[2], argv[3], filenameOf(argv[1])))
+        {
+            std::cerr << "Could not write embedded font '" << argv[2] << "'" << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (!FontWriter::write(*fontFace, argv[2]))
+    {
+        std::cerr << "Could not write binary font '" << argv[2] << "'" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}